@@ -32,6 +32,7 @@
 
 class QXmlStreamReader;
 class QXmlStreamWriter;
+class QColor;
 
 QT_BEGIN_NAMESPACE_XLSX
 
@@ -78,6 +79,13 @@ public:
     ~Chart();
 
     void addSeries(const CellRange &range, AbstractSheet *sheet=0);
+    void addSeries(const CellRange &keyRange, const CellRange &valueRange, AbstractSheet *sheet=0,
+                   const QString &name=QString(), bool secondaryAxis=false);
+    int seriesCount() const;
+    void clearSeries();
+    void setSeriesColor(int index, const QColor &color);
+    void setSeriesLineVisible(int index, bool visible);
+    void setSeriesMarkerVisible(int index, bool visible);
     void setChartType(ChartType type);
     void setChartStyle(int id);
     void setAxisTitle(Chart::ChartAxisPos pos, QString axisTitle);
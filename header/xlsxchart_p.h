@@ -47,6 +47,7 @@
 #include <QVector>
 #include <QMap>
 #include <QList>
+#include <QColor>
 
 class QXmlStreamReader;
 class QXmlStreamWriter;
@@ -56,9 +57,20 @@ namespace QXlsx {
 class XlsxSeries
 {
 public:
+    XlsxSeries()
+        :lineVisible(true), markerVisible(true), secondaryAxis(false)
+    {
+    }
+
     //At present, we care about number cell ranges only!
     QString numberDataSource_numRef; // yval, val
     QString axDataSource_numRef; // xval, cat
+
+    QString name; // literal series title, written as c:tx
+    QColor color; // line and marker color, automatic if invalid
+    bool lineVisible;
+    bool markerVisible;
+    bool secondaryAxis; // plotted against the right value axis
 };
 
 class XlsxAxis
@@ -81,10 +93,13 @@ public:
         Bottom
     };
 
-    XlsxAxis(){}
+    XlsxAxis()
+        :deleted(false), crossesMax(false)
+    {
+    }
 
     XlsxAxis(Type t, XlsxAxis::AxisPos  p, int id, int crossId, QString axisTitle = QString(""))
-        :type(t), axisPos(p), axisId(id), crossAx(crossId)
+        :type(t), axisPos(p), axisId(id), crossAx(crossId), deleted(false), crossesMax(false)
     {
         if ( !axisTitle.isEmpty() )
         {
@@ -96,6 +111,8 @@ public:
     XlsxAxis::AxisPos axisPos; // l(left),r(right),b(bottom),t(top)
     int axisId;
     int crossAx;
+    bool deleted; // axis exists for a secondary chart group but is not drawn
+    bool crossesMax; // cross the other axis at its maximum, e.g. a right-hand value axis
 
     // dev22 {{
     QMap< XlsxAxis::AxisPos, QString > axisNames;
@@ -122,6 +139,7 @@ public:
     void saveXmlBarChart(QXmlStreamWriter &writer) const;
     void saveXmlLineChart(QXmlStreamWriter &writer) const;
     void saveXmlScatterChart(QXmlStreamWriter &writer) const;
+    void saveXmlScatterChartGroup(QXmlStreamWriter &writer, bool secondary) const;
     void saveXmlAreaChart(QXmlStreamWriter &writer) const;
     void saveXmlDoughnutChart(QXmlStreamWriter &writer) const;
     void saveXmlSer(QXmlStreamWriter &writer, XlsxSeries *ser, int id) const;
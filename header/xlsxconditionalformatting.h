@@ -114,6 +114,9 @@ public:
 
     QList<CellRange> ranges() const;
 
+    void setEvaluatedOnSave(bool enable);
+    bool isEvaluatedOnSave() const;
+
     void addCell(const CellReference &cell);
     void addCell(int row, int col);
     void addRange(int firstRow, int firstCol, int lastRow, int lastCol);
@@ -124,9 +127,12 @@ public:
 
 private:
     friend class Worksheet;
+    friend class WorksheetPrivate;
     friend class ::ConditionalFormattingTest;
     bool saveToXml(QXmlStreamWriter &writer) const;
     bool loadFromXml(QXmlStreamReader &reader, Styles *styles=0);
+    quint64 matchStaticRules(int row, int col, double value) const;
+    bool isStatic() const;
     QSharedDataPointer<ConditionalFormattingPrivate> d;
 };
 
@@ -115,6 +115,9 @@ public:
     ConditionalFormattingPrivate(const ConditionalFormattingPrivate &other);
     ~ConditionalFormattingPrivate();
 
+    static bool evaluateStaticRule(const XlsxCfRuleData &rule, double value, bool *matched);
+    QList<int> priorityOrder() const;
+
     void writeCfVo(QXmlStreamWriter &writer, const XlsxCfVoData& cfvo) const;
     bool readCfVo(QXmlStreamReader &reader, XlsxCfVoData& cfvo);
     bool readCfRule(QXmlStreamReader &reader, XlsxCfRuleData *cfRule, Styles *styles);
@@ -123,6 +126,7 @@ public:
 
     QList<QSharedPointer<XlsxCfRuleData> >cfRules;
     QList<CellRange> ranges;
+    bool evaluatedOnSave; // bake the rules into cell styles when saving if all are numeric cellIs rules
 };
 
 QT_END_NAMESPACE_XLSX
@@ -59,10 +59,14 @@ public:
 	bool setColumnWidth(int colFirst, int colLast, double width);
 	bool setColumnFormat(int colFirst, int colLast, const Format &format);
 	bool setColumnHidden(int colFirst, int colLast, bool hidden);
+	bool setColumnPrecision(const CellRange &range, int decimals);
+	bool setColumnPrecision(int column, int decimals);
+	bool setColumnPrecision(int colFirst, int colLast, int decimals);
 	
 	double columnWidth(int column);
 	Format columnFormat(int column);
 	bool isColumnHidden(int column);
+	int columnPrecision(int column);
 
 	bool setRowHeight(int row, double height);
 	bool setRowFormat(int row, const Format &format);
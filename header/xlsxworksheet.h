@@ -98,9 +98,12 @@ public:
     bool setColumnWidth(int colFirst, int colLast, double width);
     bool setColumnFormat(int colFirst, int colLast, const Format &format);
     bool setColumnHidden(int colFirst, int colLast, bool hidden);
+    bool setColumnPrecision(const CellRange& range, int decimals);
+    bool setColumnPrecision(int colFirst, int colLast, int decimals);
     double columnWidth(int column);
     Format columnFormat(int column);
     bool isColumnHidden(int column);
+    int columnPrecision(int column) const;
 
     bool setRowHeight(int rowFirst,int rowLast, double height);
     bool setRowFormat(int rowFirst,int rowLast, const Format &format);
@@ -141,6 +144,9 @@ public:
 
     QVector<CellLocation> getFullCells(int* maxRow, int* maxCol);
 
+    void finalize();
+    bool isFinalized() const;
+
 private:
 
     friend class DocumentPrivate;
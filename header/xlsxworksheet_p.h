@@ -40,6 +40,9 @@
 #include <QObject>
 #include <QString>
 #include <QVector>
+#include <QPair>
+#include <QHash>
+#include <QByteArray>
 #include <QImage>
 #include <QSharedPointer>
 #include <QRegularExpression>
@@ -162,12 +165,15 @@ public:
     int checkDimensions(int row, int col, bool ignore_row=false, bool ignore_col=false);
     Format cellFormat(int row, int col) const;
     QString generateDimensionString() const;
-    void calculateSpans() const;
+    void updateSpans(int row, int col);
+    void insertCell(int row, int col, const QSharedPointer<Cell> &cell);
     void splitColsInfo(int colFirst, int colLast);
     void validateDimension();
 
     void saveXmlSheetData(QXmlStreamWriter &writer) const;
     void saveXmlCellData(QXmlStreamWriter &writer, int row, int col, QSharedPointer<Cell> cell) const;
+    int bakedXfIndex(int row, int col, double value, const Format &format) const;
+    bool rangesHaveFormula(const QList<CellRange> &ranges) const;
     void saveXmlMergeCells(QXmlStreamWriter &writer) const;
     void saveXmlHyperlinks(QXmlStreamWriter &writer) const;
     void saveXmlDrawings(QXmlStreamWriter &writer) const;
@@ -197,15 +203,20 @@ public:
     QMap<int, QSharedPointer<XlsxRowInfo> > rowsInfo;
     QMap<int, QSharedPointer<XlsxColumnInfo> > colsInfo;
     QMap<int, QSharedPointer<XlsxColumnInfo> > colsInfoHelper;
+    QMap<int, int> colsPrecision; // decimals numeric values are stored with, per column
 
     QList<DataValidation> dataValidationsList;
     QList<ConditionalFormatting> conditionalFormattingList;
+    mutable QList<int> bakedCfIndexes; // formattings whose rules are baked into cell styles on save
+    mutable QHash<QPair<int, QPair<int, quint64> >, int> bakedXfIndexes; // (style, (formatting, rule mask)) -> baked style
     QMap<int, CellFormula> sharedFormulaMap;
 
     CellRange dimension;
     int previous_row;
 
-    mutable QMap<int, QString> row_spans;
+    QByteArray finalizedXml; // sheet XML kept after finalize() released the cells
+
+    QMap<int, QPair<int, int> > row_spans; // first/last column per block of 16 rows
     QMap<int, double> row_sizes;
     QMap<int, double> col_sizes;
 
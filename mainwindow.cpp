@@ -72,16 +72,9 @@ MainWindow::MainWindow(QWidget *parent) :
     player->setMedia(QUrl("qrc:/sound/alarm.wav"));
 
 
+    // the samples of the current run are kept in the shift workbook only, the excel export copies them from there
     this->excelFileName = "Data-Test.xlsx";
 
-    // give the excel file column headers
-    this->xldoc.write( 1 , 1, "Time");
-    this->xldoc.write( 1 , 2, "Percent On");
-    this->xldoc.write( 1 , 3, "Temperature");
-    this->xldoc.write( 1 , 4, "Filtered Temperature");
-    this->xldoc.write( 1 , 5, "Set Point");
-    this->xldoc.write( 1 , 6, "Fan Speed");
-
 
 
     /*
@@ -108,6 +101,15 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->plot->graph(3)->setName("Percent Heater on");
     ui->plot->graph(3)->setPen(QPen(QColor("purple"))); // line color for the first graph
 
+    // line graphs keep a min/max pyramid so replotting a whole shift stays as fast as a short run
+    for (int i = 1; i < ui->plot->graphCount(); i++) {
+        ui->plot->graph(i)->setLodPyramid(true);
+    }
+
+    // give the graphs their own buffer, so a new sample only redraws them and not the grid and axes
+    ui->plot->layer("main")->setMode(QCPLayer::lmBuffered);
+    ui->plot->setPlottingHint(QCP::phDirtyLayerReplot);
+
 
     ui->plot->xAxis2->setVisible(true);  // show x ticks at top
     ui->plot->xAxis2->setVisible(false); // dont show labels at top
@@ -158,6 +160,15 @@ MainWindow::~MainWindow()
 
     this->csvdoc.close();
 
+    // finish this run in the shift workbook
+    if (this->archive) {
+        this->archive->endRun(static_cast<double>(com.get(i_score)),
+                              static_cast<double>(com.get(i_avg_err)),
+                              static_cast<double>(com.get(i_inputVar)));
+        this->archive->save();
+        delete this->archive;
+    }
+
     delete player;
     delete ui;
 }
@@ -218,6 +229,13 @@ void MainWindow::showRequest(const QString &req)
                 qDebug() << " \n ERROR : " << err;
             }
 
+            // every run of the day goes into one workbook, a sheet per run
+            QString shiftStr = currentTime.toString("d-MMM-yyyy");
+            this->archive = new RunArchive("..\\log_files\\" + shiftStr + "-Shift.xlsx");
+            QString runName = "Run " + currentTime.toString("h-mm-ss-A");
+            if (!this->archive->beginRun(runName))
+                qDebug() << " Failed to start " << runName << " in the run archive, this run is not archived\n";
+
         }
 
         double time       = static_cast<double>(com.get(i_time));
@@ -254,13 +272,13 @@ void MainWindow::showRequest(const QString &req)
         if (!ui->outputTable->underMouse())
             ui->outputTable->scrollToBottom();   // scroll to the bottom to ensure the last value is visible
 
-        // add each value into the excel file ( the silly math here is to format the float to have only 2 decimals )
-        this->xldoc.write(ui->outputTable->rowCount(), 1,  (qRound(time*100))/100.0);
-        this->xldoc.write(ui->outputTable->rowCount(), 2,  (qRound(percentOn*100))/100.0);
-        this->xldoc.write(ui->outputTable->rowCount(), 3,  (qRound(temp*100))/100.0);
-        this->xldoc.write(ui->outputTable->rowCount(), 4,  (qRound(tempFilt*100))/100.0);
-        this->xldoc.write(ui->outputTable->rowCount(), 5,  (qRound(setPoint*100))/100.0);
-        this->xldoc.write(ui->outputTable->rowCount(), 6,  (qRound(fanSpeed*100))/100.0);
+        // add each value to the run in the shift workbook, the columns are stored with 2 decimals.
+        // the workbook is saved regularly, so a crash only loses the last few samples
+        if (this->archive && this->archive->isRunning()) {
+            this->archive->addSample(time, percentOn, temp, tempFilt, setPoint, fanSpeed);
+            if (this->archive->sampleCount() % archiveSaveInterval == 0)
+                this->archive->save();
+        }
 
         /*
         *  Update the csv file with the last data read from the port
@@ -558,11 +576,52 @@ void MainWindow::on_actionExport_Excel_File_triggered()
     qDebug() << "Saving excel file with Filename: " << this->excelFileName << "\n";
 
     if(!this->excelFileName.isNull()) {    // The user chose a valid filname
-        this->xldoc.saveAs(this->excelFileName);
+        if (!this->archive || !this->archive->isRunning()) {
+            qDebug() << " No run in progress, nothing to export\n";
+            return;
+        }
+        QXlsx::Document exportDoc;
+        this->archive->exportRun(exportDoc);
+        // values are logged at full precision, the sheet stores them with 2 decimals
+        exportDoc.setColumnPrecision(1, 6, 2);
+        addExcelChart(exportDoc, this->archive->sampleCount() + 1);
+        if (!exportDoc.saveAs(this->excelFileName))
+            qDebug() << " Failed to save excel file " << this->excelFileName << "\n";
     }
 
 }
 
+/**
+ * Adds a chart to 'doc' that mirrors the live plot, one series per graph, for the data up to 'lastRow'.
+ * The series only reference the logged columns, so the cells are never re-read
+ * and this costs the same no matter how long the run is.
+ */
+void MainWindow::addExcelChart(QXlsx::Document &doc, int lastRow)
+{
+    if (lastRow < 2)  // data starts on row 2 of the excel file
+        return;
+
+    Chart* xlChart = doc.insertChart(1, 7, QSize(720, 420));
+    xlChart->setChartType(Chart::CT_Scatter);
+    xlChart->setAxisTitle(Chart::Bottom, ui->plot->xAxis->label());
+    xlChart->setAxisTitle(Chart::Left, ui->plot->yAxis->label());
+    xlChart->setAxisTitle(Chart::Right, ui->plot->yAxis2->label());
+
+    // excel column holding the data of each graph in the plot
+    const int graphColumn[] = { 5, 4, 3, 2 }; // Set Point, Filtered Temperature, Temperature, Percent On
+    CellRange timeRange(2, 1, lastRow, 1);
+    for (int i = 0; i < ui->plot->graphCount() && i < 4; i++) {
+        QCPGraph* graph = ui->plot->graph(i);
+        bool scatter = !graph->scatterStyle().isNone();  // the set point is shown as dots only
+        CellRange valueRange(2, graphColumn[i], lastRow, graphColumn[i]);
+        xlChart->addSeries(timeRange, valueRange, nullptr, graph->name(), graph->valueAxis() == ui->plot->yAxis2);
+        int index = xlChart->seriesCount() - 1;
+        xlChart->setSeriesColor(index, scatter ? graph->scatterStyle().pen().color() : graph->pen().color());
+        xlChart->setSeriesLineVisible(index, !scatter);
+        xlChart->setSeriesMarkerVisible(index, scatter);
+    }
+}
+
 /**
  * @brief MainWindow::on_auto_fit_CheckBox_stateChanged
  * Called when the user clicked the auto-fit checkbox, changes the default settings of the graph to fit the data.
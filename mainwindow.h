@@ -32,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 using namespace QXlsx;
 
 #include "port.h"
+#include "runarchive.h"
 #include "PWCL_test\com.h"
 
 #define i_kc            0
@@ -99,8 +100,10 @@ private:
     bool validConnection;
 
     QString excelFileName;
-    QXlsx::Document xldoc;
+    void addExcelChart(QXlsx::Document &doc, int lastRow);
     QFile csvdoc;
+    RunArchive* archive = nullptr;
+    static const int archiveSaveInterval = 60; // samples between saves of the shift workbook
     QMediaPlayer* player;
 
     float nominalPercentOn = 0;
@@ -615,6 +615,25 @@ void QCPAbstractPaintBuffer::setInvalidated(bool invalidated)
   mInvalidated = invalidated;
 }
 
+/*!
+  Moves the contents of this buffer inside \a rect by \a dx and \a dy device pixels. The area of \a
+  rect that is exposed by the move keeps its previous contents, the caller is responsible for
+  clearing and redrawing it. \a rect is given in logical (device independent) pixels.
+
+  This is used by the strip chart mode of \ref QCPAxisRect (see \ref QCPAxisRect::setStripChart) to
+  reuse the previous frame when the data has only scrolled.
+
+  Returns whether the buffer supports scrolling. The base implementation doesn't and returns false,
+  in which case the buffer is redrawn completely.
+*/
+bool QCPAbstractPaintBuffer::scroll(int dx, int dy, const QRect &rect)
+{
+  Q_UNUSED(dx)
+  Q_UNUSED(dy)
+  Q_UNUSED(rect)
+  return false;
+}
+
 /*!
   Sets the the device pixel ratio to \a ratio. This is useful to render on high-DPI output devices.
   The ratio is automatically set to the device pixel ratio used by the parent QCustomPlot instance.
@@ -686,6 +705,15 @@ void QCPPaintBufferPixmap::clear(const QColor &color)
   mBuffer.fill(color);
 }
 
+/* inherits documentation from base class */
+bool QCPPaintBufferPixmap::scroll(int dx, int dy, const QRect &rect)
+{
+  // QPixmap::scroll works in device pixels, so the rect needs to be scaled by the pixel ratio:
+  const QRect deviceRect(qFloor(rect.left()*mDevicePixelRatio), qFloor(rect.top()*mDevicePixelRatio), qCeil(rect.width()*mDevicePixelRatio), qCeil(rect.height()*mDevicePixelRatio));
+  mBuffer.scroll(dx, dy, deviceRect);
+  return true;
+}
+
 /* inherits documentation from base class */
 void QCPPaintBufferPixmap::reallocateBuffer()
 {
@@ -1045,7 +1073,8 @@ QCPLayer::QCPLayer(QCustomPlot *parentPlot, const QString &layerName) :
   mName(layerName),
   mIndex(-1), // will be set to a proper value by the QCustomPlot layer creation function
   mVisible(true),
-  mMode(lmLogical)
+  mMode(lmLogical),
+  mDirty(true)
 {
   // Note: no need to make sure layerName is unique, because layer
   // management is done with QCustomPlot functions.
@@ -1113,9 +1142,12 @@ void QCPLayer::setMode(QCPLayer::LayerMode mode)
 
   Draws the contents of this layer with the provided \a painter.
 
+  If \a clipRect is valid, drawing is additionally restricted to it. This is used to only redraw
+  the newly exposed part of a scrolled strip chart (see \ref QCPAxisRect::setStripChart).
+
   \see replot, drawToPaintBuffer
 */
-void QCPLayer::draw(QCPPainter *painter)
+void QCPLayer::draw(QCPPainter *painter, const QRect &clipRect)
 {
   foreach (QCPLayerable *child, mChildren)
   {
@@ -1123,6 +1155,8 @@ void QCPLayer::draw(QCPPainter *painter)
     {
       painter->save();
       painter->setClipRect(child->clipRect().translated(0, -1));
+      if (clipRect.isValid())
+        painter->setClipRect(clipRect, Qt::IntersectClip);
       child->applyDefaultAntialiasingHint(painter);
       child->draw(painter);
       painter->restore();
@@ -1136,17 +1170,30 @@ void QCPLayer::draw(QCPPainter *painter)
   association is established by the parent QCustomPlot, which manages all paint buffers (see \ref
   QCustomPlot::setupPaintBuffers).
 
+  If \a clipRect is valid, the area of \a clipRect is cleared in the paint buffer and only that area
+  is redrawn, the rest of the buffer is left untouched. Otherwise, the layer is drawn with \ref
+  drawTiled if possible.
+
   \see draw
 */
-void QCPLayer::drawToPaintBuffer()
+void QCPLayer::drawToPaintBuffer(const QRect &clipRect)
 {
   if (!mPaintBuffer.isNull())
   {
     if (QCPPainter *painter = mPaintBuffer.data()->startPainting())
     {
       if (painter->isActive())
-        draw(painter);
-      else
+      {
+        if (clipRect.isValid())
+        {
+          painter->save();
+          painter->setCompositionMode(QPainter::CompositionMode_Source);
+          painter->fillRect(clipRect, Qt::transparent);
+          painter->restore();
+        }
+        if (clipRect.isValid() || !drawTiled(painter))
+          draw(painter, clipRect);
+      } else
         qDebug() << Q_FUNC_INFO << "paint buffer returned inactive painter";
       delete painter;
       mPaintBuffer.data()->donePainting();
@@ -1156,6 +1203,203 @@ void QCPLayer::drawToPaintBuffer()
     qDebug() << Q_FUNC_INFO << "no valid paint buffer associated with this layer";
 }
 
+/*! \internal
+
+  Draws the contents of this layer with \a painter by rasterizing it in horizontal tiles on several
+  threads, if the plotting hint \ref QCP::phTiledRaster is set. Returns false without drawing
+  anything if tiled drawing isn't possible, the caller then needs to draw the layer with \ref draw.
+
+  The tiles are bands of rows of one shared image, each tile is drawn by \ref drawTile with its own
+  painter clipped to the band. One tile is drawn on the calling thread, the others on the thread
+  pool of the parent plot. Finally, the image is drawn onto \a painter. Since every tile still
+  prepares the complete data of each plottable, tiling pays off when rasterization dominates, i.e.
+  for large or high-DPI plots with antialiased lines, fills or scatters.
+
+  Only layers with nothing but plottables are drawn tiled, because other layerables (e.g. axes with
+  their label cache) aren't safe to draw concurrently. Color maps are excluded, too, since they
+  update their map image while drawing. The same holds for graphs with background preparation
+  (\ref QCPGraph::setBackgroundPreparation), which take over their prepared buffers while drawing,
+  and for streaming curves (\ref QCPCurve::setStreaming), which update their cached lines.
+  Finally, plottables that paint pixmaps (see \ref drawsPixmaps) are excluded, because QPixmaps may
+  only be used on the GUI thread.
+*/
+bool QCPLayer::drawTiled(QCPPainter *painter)
+{
+  const int minTileHeight = 64; // device pixels, smaller tiles aren't worth the overhead of another thread
+  if (!mParentPlot->plottingHints().testFlag(QCP::phTiledRaster) || mParentPlot->openGl() || mPaintBuffer.isNull())
+    return false;
+  bool hasVisibleChild = false;
+  foreach (QCPLayerable *child, mChildren)
+  {
+    if (!child->realVisibility())
+      continue;
+    if (!qobject_cast<QCPAbstractPlottable*>(child) || qobject_cast<QCPColorMap*>(child))
+      return false;
+    if (drawsPixmaps(qobject_cast<QCPAbstractPlottable*>(child)))
+      return false;
+    if (QCPGraph *graph = qobject_cast<QCPGraph*>(child))
+    {
+      if (graph->backgroundPreparation())
+        return false;
+    } else if (QCPCurve *curve = qobject_cast<QCPCurve*>(child))
+    {
+      if (curve->streaming())
+        return false;
+    }
+    hasVisibleChild = true;
+  }
+  if (!hasVisibleChild)
+    return false;
+  
+  const double devicePixelRatio = mPaintBuffer.data()->devicePixelRatio();
+  const QSize deviceSize = mPaintBuffer.data()->size()*devicePixelRatio;
+  const int tileCount = qMin(QThread::idealThreadCount(), deviceSize.height()/minTileHeight);
+  if (tileCount < 2)
+    return false;
+  
+  QImage image(deviceSize, QImage::Format_ARGB32_Premultiplied);
+  if (image.isNull())
+    return false;
+  image.fill(Qt::transparent);
+  uchar *bits = image.bits(); // tiles paint directly into the rows of image, so no composition of tiles is necessary
+  for (int i=0; i<tileCount; ++i)
+  {
+    const int top = deviceSize.height()*i/tileCount;
+    const int bottom = deviceSize.height()*(i+1)/tileCount;
+    const QRect deviceRect(0, top, deviceSize.width(), bottom-top);
+    if (i < tileCount-1)
+      mParentPlot->mRasterThreadPool.start(new QCPLayerTileTask(this, bits, image.bytesPerLine(), deviceRect, devicePixelRatio, painter->renderHints(), painter->modes()));
+    else
+      drawTile(bits, image.bytesPerLine(), deviceRect, devicePixelRatio, painter->renderHints(), painter->modes());
+  }
+  mParentPlot->mRasterThreadPool.waitForDone();
+  
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  image.setDevicePixelRatio(devicePixelRatio);
+#endif
+  painter->drawImage(QPointF(0, 0), image);
+  return true;
+}
+
+/*! \internal
+
+  Returns whether \a plottable may paint QPixmaps, i.e. uses a pen or brush with a texture, or a
+  scatter style of shape \ref QCPScatterStyle::ssPixmap, either regularly or for its selected
+  parts. Such plottables can't be drawn by \ref drawTiled.
+*/
+bool QCPLayer::drawsPixmaps(const QCPAbstractPlottable *plottable)
+{
+  QList<QPen> pens;
+  QList<QBrush> brushes;
+  QList<QCPScatterStyle> scatterStyles;
+  pens << plottable->pen();
+  brushes << plottable->brush();
+  if (QCPSelectionDecorator *decorator = plottable->selectionDecorator())
+  {
+    pens << decorator->pen();
+    brushes << decorator->brush();
+    scatterStyles << decorator->scatterStyle();
+  }
+  if (const QCPGraph *graph = qobject_cast<const QCPGraph*>(plottable))
+    scatterStyles << graph->scatterStyle();
+  else if (const QCPCurve *curve = qobject_cast<const QCPCurve*>(plottable))
+    scatterStyles << curve->scatterStyle();
+  else if (const QCPStatisticalBox *box = qobject_cast<const QCPStatisticalBox*>(plottable))
+    scatterStyles << box->outlierStyle();
+  
+  foreach (const QPen &pen, pens)
+  {
+    if (pen.brush().style() == Qt::TexturePattern)
+      return true;
+  }
+  foreach (const QBrush &brush, brushes)
+  {
+    if (brush.style() == Qt::TexturePattern)
+      return true;
+  }
+  foreach (const QCPScatterStyle &style, scatterStyles)
+  {
+    if (style.shape() == QCPScatterStyle::ssPixmap || style.pen().brush().style() == Qt::TexturePattern || style.brush().style() == Qt::TexturePattern)
+      return true;
+  }
+  return false;
+}
+
+/*! \internal
+
+  Draws the part of this layer that falls into \a deviceRect, given in device pixels of the paint
+  buffer. \a bits and \a bytesPerLine describe the image (of format
+  QImage::Format_ARGB32_Premultiplied) the whole layer is drawn to. The painter on the tile is
+  configured with \a renderHints and \a modes of the paint buffer's painter.
+
+  This is called concurrently on several threads by \ref drawTiled. Each call wraps its rows of the
+  image in its own QImage, which must not be shared with other threads, because painting on a
+  shared QImage would detach it.
+*/
+void QCPLayer::drawTile(uchar *bits, int bytesPerLine, const QRect &deviceRect, double devicePixelRatio, QPainter::RenderHints renderHints, QCPPainter::PainterModes modes)
+{
+  QImage tile(bits+deviceRect.top()*bytesPerLine, deviceRect.width(), deviceRect.height(), bytesPerLine, QImage::Format_ARGB32_Premultiplied);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  tile.setDevicePixelRatio(devicePixelRatio);
+#endif
+  QCPPainter painter(&tile);
+  if (!painter.isActive())
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't activate painter on tile";
+    return;
+  }
+  painter.setRenderHints(renderHints);
+  painter.setModes(modes);
+  const double top = deviceRect.top()/devicePixelRatio;
+  const QRectF tileRect(0, top, deviceRect.width()/devicePixelRatio, deviceRect.height()/devicePixelRatio);
+  painter.translate(0, -top);
+  foreach (QCPLayerable *child, mChildren)
+  {
+    if (child->realVisibility())
+    {
+      painter.save();
+      painter.setClipRect(child->clipRect().translated(0, -1));
+      painter.setClipRect(tileRect, Qt::IntersectClip);
+      child->applyDefaultAntialiasingHint(&painter);
+      child->draw(&painter);
+      painter.restore();
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPLayerTileTask
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPLayerTileTask
+  \brief Draws one tile of a layer on a thread pool
+
+  This is an internal class used by \ref QCPLayer::drawTiled when the plotting hint \ref
+  QCP::phTiledRaster is set. It calls \ref QCPLayer::drawTile for a single tile.
+*/
+
+/*!
+  Creates a task that draws the part of \a layer falling into \a deviceRect. The parameters are
+  passed on to \ref QCPLayer::drawTile.
+*/
+QCPLayerTileTask::QCPLayerTileTask(QCPLayer *layer, uchar *bits, int bytesPerLine, const QRect &deviceRect, double devicePixelRatio, QPainter::RenderHints renderHints, QCPPainter::PainterModes modes) :
+  mLayer(layer),
+  mBits(bits),
+  mBytesPerLine(bytesPerLine),
+  mDeviceRect(deviceRect),
+  mDevicePixelRatio(devicePixelRatio),
+  mRenderHints(renderHints),
+  mModes(modes)
+{
+}
+
+/* inherits documentation from base class */
+void QCPLayerTileTask::run()
+{
+  mLayer->drawTile(mBits, mBytesPerLine, mDeviceRect, mDevicePixelRatio, mRenderHints, mModes);
+}
+
 /*!
   If the layer mode (\ref setMode) is set to \ref lmBuffered, this method allows replotting only
   the layerables on this specific layer, without the need to replot all other layers (as a call to
@@ -1178,6 +1422,7 @@ void QCPLayer::replot()
       mPaintBuffer.data()->clear(Qt::transparent);
       drawToPaintBuffer();
       mPaintBuffer.data()->setInvalidated(false);
+      mDirty = false;
       mParentPlot->update();
     } else
       qDebug() << Q_FUNC_INFO << "no valid paint buffer associated with this layer";
@@ -1185,6 +1430,26 @@ void QCPLayer::replot()
     mParentPlot->replot();
 }
 
+/*!
+  Marks this layer as dirty, i.e. its contents have changed since the last replot.
+
+  If the plotting hint \ref QCP::phDirtyLayerReplot is set, \ref QCustomPlot::replot only redraws
+  the paint buffers holding dirty layers, as long as the layout and all axis ranges stayed the same.
+  The buffers of all other layers are composited as they are from the previous replot. Plottables
+  call this method on their layer when data is added or set, so in a typical live plot with fixed
+  axis ranges only the layer with the plottables is redrawn. To benefit from this, that layer
+  should be in \ref lmBuffered mode, so it doesn't share a paint buffer with the grid and axes.
+
+  When changing other properties of layerables (e.g. pens or visibility) while the hint is set,
+  call this method on their layer so the change becomes visible on the next replot.
+
+  The dirty flag is cleared whenever the layer is drawn.
+*/
+void QCPLayer::markDirty()
+{
+  mDirty = true;
+}
+
 /*! \internal
   
   Adds the \a layerable to the list of this layer. If \a prepend is set to true, the layerable will
@@ -1528,6 +1793,20 @@ void QCPLayerable::setParentLayerable(QCPLayerable *parentLayerable)
   mParentLayerable = parentLayerable;
 }
 
+/*! \internal
+
+  Marks the layer this layerable resides on as dirty, so it is redrawn on the next replot even if
+  the plotting hint \ref QCP::phDirtyLayerReplot is set. Subclasses call this when their content
+  changed without affecting the layout or axis ranges, e.g. when data was added.
+
+  \see QCPLayer::markDirty
+*/
+void QCPLayerable::markLayerDirty()
+{
+  if (mLayer)
+    mLayer->markDirty();
+}
+
 /*! \internal
   
   Moves this layerable object to \a layer. If \a prepend is true, this object will be prepended to
@@ -5482,6 +5761,13 @@ void QCPLineEnding::draw(QCPPainter *painter, const QCPVector2D &pos, double ang
   getTickLabel, but your reimplementations don't necessarily need to do so. For example in the case
   of unequal tick steps, the method \ref getTickStep loses its usefulness and can be ignored.
   
+  The default implementation of \ref createTickVector reuses the ticks of the previous call, as
+  long as tick step and tick origin stay the same. If enabled with \ref setCacheLabels, \ref
+  createLabelVector likewise reuses the labels of ticks that were already labeled, as long as the
+  number format stays the same as well. Label caching is off by default, because a reimplemented
+  \ref getTickLabel may depend on further state. If you enable it in your subclass, call \ref
+  clearTickCache whenever such state changes.
+  
   The sub tick count between major ticks can be controlled with \ref getSubTickCount. Full sub tick
   placement control is obtained by reimplementing \ref createSubTickVector.
   
@@ -5496,7 +5782,11 @@ void QCPLineEnding::draw(QCPPainter *painter, const QCPVector2D &pos, double ang
 QCPAxisTicker::QCPAxisTicker() :
   mTickStepStrategy(tssReadability),
   mTickCount(5),
-  mTickOrigin(0)
+  mTickOrigin(0),
+  mCacheLabels(false),
+  mCachedTickStep(0),
+  mCachedTickOrigin(0),
+  mCachedPrecision(0)
 {
 }
 
@@ -5543,6 +5833,23 @@ void QCPAxisTicker::setTickOrigin(double origin)
   mTickOrigin = origin;
 }
 
+/*!
+  Sets whether the default implementation of \ref createLabelVector reuses the labels of ticks that
+  were already labeled in the previous call, so only the labels of newly exposed ticks are
+  generated while a plot scrolls. Cached labels are discarded when tick step, tick origin or number
+  format change.
+  
+  Only enable this if \ref getTickLabel depends on nothing else, or if the ticker calls \ref
+  clearTickCache whenever the further state changes. The built-in tickers except \ref
+  QCPAxisTickerText enable it, as does the default ticker of QCPAxis. The default is false.
+*/
+void QCPAxisTicker::setCacheLabels(bool enabled)
+{
+  mCacheLabels = enabled;
+  if (!mCacheLabels)
+    clearTickCache();
+}
+
 /*!
   This is the method called by QCPAxis in order to actually generate tick coordinates (\a ticks),
   tick label strings (\a tickLabels) and sub tick coordinates (\a subTicks).
@@ -5558,8 +5865,19 @@ void QCPAxisTicker::setTickOrigin(double origin)
 */
 void QCPAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels)
 {
-  // generate (major) ticks:
   double tickStep = getTickStep(range);
+  // cached ticks and labels can only be reused if they were generated with the same parameters:
+  if (tickStep != mCachedTickStep || mTickOrigin != mCachedTickOrigin || locale != mCachedLocale || formatChar != mCachedFormatChar || precision != mCachedPrecision)
+  {
+    clearTickCache();
+    mCachedTickStep = tickStep;
+    mCachedTickOrigin = mTickOrigin;
+    mCachedLocale = locale;
+    mCachedFormatChar = formatChar;
+    mCachedPrecision = precision;
+  }
+  
+  // generate (major) ticks:
   ticks = createTickVector(tickStep, range);
   trimTicks(range, ticks, true); // trim ticks to visible range plus one outer tick on each side (incase a subclass createTickVector creates more)
   
@@ -5711,18 +6029,32 @@ QVector<double> QCPAxisTicker::createSubTickVector(int subTickCount, const QVect
   this method. Depending on the purpose of the subclass it doesn't necessarily need to base its
   result on \a tickStep, e.g. when the ticks are spaced unequally like in the case of
   QCPAxisTickerLog.
+  
+  The default implementation generates ticks beyond \a range, and returns the same ticks again as
+  long as they cover the requested range and the tick step and origin are unchanged (see \ref
+  generate). This avoids regenerating the ticks of a slowly moving range, e.g. in a live plot. The
+  surplus ticks are removed by \ref generate.
 */
 QVector<double> QCPAxisTicker::createTickVector(double tickStep, const QCPRange &range)
 {
+  if (!mCachedTicks.isEmpty() && tickStep == mCachedTickStep && mTickOrigin == mCachedTickOrigin &&
+      mCachedTicks.first() <= range.lower && mCachedTicks.last() >= range.upper)
+    return mCachedTicks;
+  
   QVector<double> result;
+  // extend the generated ticks beyond the range (limited to a few hundred ticks), so they can be reused while the range moves:
+  const double margin = qMin(range.size(), 100*tickStep);
   // Generate tick positions according to tickStep:
-  qint64 firstStep = floor((range.lower-mTickOrigin)/tickStep); // do not use qFloor here, or we'll lose 64 bit precision
-  qint64 lastStep = ceil((range.upper-mTickOrigin)/tickStep); // do not use qCeil here, or we'll lose 64 bit precision
+  qint64 firstStep = floor((range.lower-margin-mTickOrigin)/tickStep); // do not use qFloor here, or we'll lose 64 bit precision
+  qint64 lastStep = ceil((range.upper+margin-mTickOrigin)/tickStep); // do not use qCeil here, or we'll lose 64 bit precision
   int tickcount = lastStep-firstStep+1;
   if (tickcount < 0) tickcount = 0;
   result.resize(tickcount);
   for (int i=0; i<tickcount; ++i)
     result[i] = mTickOrigin + (firstStep+i)*tickStep;
+  mCachedTicks = result;
+  mCachedTickStep = tickStep;
+  mCachedTickOrigin = mTickOrigin;
   return result;
 }
 
@@ -5730,7 +6062,8 @@ QVector<double> QCPAxisTicker::createTickVector(double tickStep, const QCPRange
   
   Returns a vector containing all tick label strings corresponding to the tick coordinates provided
   in \a ticks. The default implementation calls \ref getTickLabel to generate the respective
-  strings.
+  strings, except for ticks that already had a label in the previous call if \ref setCacheLabels
+  is enabled.
   
   It is possible but uncommon for QCPAxisTicker subclasses to reimplement this method, as
   reimplementing \ref getTickLabel often achieves the intended result easier.
@@ -5739,11 +6072,42 @@ QVector<QString> QCPAxisTicker::createLabelVector(const QVector<double> &ticks,
 {
   QVector<QString> result;
   result.reserve(ticks.size());
+  // ticks which were already labeled in the previous call are found by walking the sorted ticks in parallel:
+  int cachedIndex = 0;
+  const int cachedCount = mCacheLabels ? mCachedLabelTicks.size() : 0;
   for (int i=0; i<ticks.size(); ++i)
-    result.append(getTickLabel(ticks.at(i), locale, formatChar, precision));
+  {
+    const double tick = ticks.at(i);
+    while (cachedIndex < cachedCount && mCachedLabelTicks.at(cachedIndex) < tick)
+      ++cachedIndex;
+    if (cachedIndex < cachedCount && mCachedLabelTicks.at(cachedIndex) == tick)
+      result.append(mCachedLabels.at(cachedIndex));
+    else
+      result.append(getTickLabel(tick, locale, formatChar, precision));
+  }
+  if (mCacheLabels)
+  {
+    mCachedLabelTicks = ticks;
+    mCachedLabels = result;
+  }
   return result;
 }
 
+/*! \internal
+  
+  Discards the ticks and labels cached by the default implementations of \ref createTickVector and
+  \ref createLabelVector. The next call of \ref generate creates all ticks and labels anew.
+  
+  Subclasses call this method when a property changes which affects the ticks or labels, but isn't
+  already covered by the tick step, tick origin and number format passed to \ref generate.
+*/
+void QCPAxisTicker::clearTickCache()
+{
+  mCachedTicks.clear();
+  mCachedLabelTicks.clear();
+  mCachedLabels.clear();
+}
+
 /*! \internal
   
   Removes tick coordinates from \a ticks which lie outside the specified \a range. If \a
@@ -5902,6 +6266,7 @@ QCPAxisTickerDateTime::QCPAxisTickerDateTime() :
   mDateStrategy(dsNone)
 {
   setTickCount(4);
+  setCacheLabels(true);
 }
 
 /*!
@@ -5915,6 +6280,7 @@ QCPAxisTickerDateTime::QCPAxisTickerDateTime() :
 void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 {
   mDateTimeFormat = format;
+  clearTickCache();
 }
 
 /*!
@@ -5930,6 +6296,7 @@ void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 void QCPAxisTickerDateTime::setDateTimeSpec(Qt::TimeSpec spec)
 {
   mDateTimeSpec = spec;
+  clearTickCache();
 }
 
 /*!
@@ -6199,6 +6566,7 @@ QCPAxisTickerTime::QCPAxisTickerTime() :
   mBiggestUnit(tuHours)
 {
   setTickCount(4);
+  setCacheLabels(true);
   mFieldWidth[tuMilliseconds] = 3;
   mFieldWidth[tuSeconds] = 2;
   mFieldWidth[tuMinutes] = 2;
@@ -6233,6 +6601,7 @@ QCPAxisTickerTime::QCPAxisTickerTime() :
 void QCPAxisTickerTime::setTimeFormat(const QString &format)
 {
   mTimeFormat = format;
+  clearTickCache();
   
   // determine smallest and biggest unit in format, to optimize unit replacement and allow biggest
   // unit to consume remaining time of a tick value and grow beyond its modulo (e.g. min > 59)
@@ -6264,6 +6633,7 @@ void QCPAxisTickerTime::setTimeFormat(const QString &format)
 void QCPAxisTickerTime::setFieldWidth(QCPAxisTickerTime::TimeUnit unit, int width)
 {
   mFieldWidth[unit] = qMax(width, 1);
+  clearTickCache();
 }
 
 /*! \internal
@@ -6430,6 +6800,7 @@ QCPAxisTickerFixed::QCPAxisTickerFixed() :
   mTickStep(1.0),
   mScaleStrategy(ssNone)
 {
+  setCacheLabels(true);
 }
 
 /*!
@@ -6745,6 +7116,7 @@ QCPAxisTickerPi::QCPAxisTickerPi() :
   mPiTickStep(0)
 {
   setTickCount(4);
+  setCacheLabels(true);
 }
 
 /*!
@@ -6757,6 +7129,7 @@ QCPAxisTickerPi::QCPAxisTickerPi() :
 void QCPAxisTickerPi::setPiSymbol(QString symbol)
 {
   mPiSymbol = symbol;
+  clearTickCache();
 }
 
 /*!
@@ -6768,6 +7141,7 @@ void QCPAxisTickerPi::setPiSymbol(QString symbol)
 void QCPAxisTickerPi::setPiValue(double pi)
 {
   mPiValue = pi;
+  clearTickCache();
 }
 
 /*!
@@ -6781,6 +7155,7 @@ void QCPAxisTickerPi::setPiValue(double pi)
 void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 {
   mPeriodicity = qAbs(multiplesOfPi);
+  clearTickCache();
 }
 
 /*!
@@ -6790,6 +7165,7 @@ void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 void QCPAxisTickerPi::setFractionStyle(QCPAxisTickerPi::FractionStyle style)
 {
   mFractionStyle = style;
+  clearTickCache();
 }
 
 /*! \internal
@@ -7033,6 +7409,7 @@ QCPAxisTickerLog::QCPAxisTickerLog() :
   mSubTickCount(8), // generates 10 intervals
   mLogBaseLnInv(1.0/qLn(mLogBase))
 {
+  setCacheLabels(true);
 }
 
 /*!
@@ -7548,6 +7925,7 @@ QCPAxis::QCPAxis(QCPAxisRect *parent, AxisType type) :
   mCachedMargin(0)
 {
   setParent(parent);
+  mTicker->setCacheLabels(true);
   mGrid->setVisible(false);
   setAntialiased(false);
   setLayer(mParentPlot->currentLayer()); // it's actually on that layer already, but we want it in front of the grid, so we place it on there again
@@ -8650,6 +9028,54 @@ double QCPAxis::coordToPixel(double value) const
   }
 }
 
+/*! \overload
+
+  Transforms \a count values, in coordinates of the axis, to pixel coordinates of the QCustomPlot
+  widget. The values are read from \a values and the results written to \a pixels, advancing by \a
+  valueStride and \a pixelStride doubles per element, respectively. This allows transforming a
+  member of an array of data structs (e.g. the keys of QCPGraphData) directly into one coordinate
+  of an array of points.
+
+  The result is the same as calling \ref coordToPixel(double value) const for each value. However,
+  the orientation, scale type and range reversal are resolved only once, so the loop over the values
+  is a single multiply-add (or logarithm) per element that the compiler can vectorize. Use this when
+  transforming many values at once, e.g. when generating the lines of a plottable.
+*/
+void QCPAxis::coordToPixel(const double *values, double *pixels, int count, int valueStride, int pixelStride) const
+{
+  if (count <= 0)
+    return;
+  const bool horizontal = orientation() == Qt::Horizontal;
+  
+  // every transform has the form pixel = base + factor*f(value), with f being the offset or the log ratio to origin:
+  const double origin = mRangeReversed ? mRange.upper : mRange.lower;
+  const double base = horizontal ? mAxisRect->left() : mAxisRect->bottom();
+  const double extent = (horizontal ? mAxisRect->width() : -mAxisRect->height())*(mRangeReversed ? -1 : 1);
+  if (mScaleType == stLinear)
+  {
+    const double factor = extent/mRange.size();
+    for (int i=0; i<count; ++i)
+      pixels[i*pixelStride] = (values[i*valueStride]-origin)*factor+base;
+  } else // mScaleType == stLogarithmic
+  {
+    const double factor = extent/qLn(mRange.upper/mRange.lower);
+    // invalid values for logarithmic scale are drawn outside the visible range, on the side they belong to:
+    const double upperOutside = horizontal ? (!mRangeReversed ? mAxisRect->right()+200 : mAxisRect->left()-200) : (!mRangeReversed ? mAxisRect->top()-200 : mAxisRect->bottom()+200);
+    const double lowerOutside = horizontal ? (!mRangeReversed ? mAxisRect->left()-200 : mAxisRect->right()+200) : (!mRangeReversed ? mAxisRect->bottom()+200 : mAxisRect->top()-200);
+    const bool negativeRange = mRange.upper < 0.0;
+    for (int i=0; i<count; ++i)
+    {
+      const double value = values[i*valueStride];
+      if (value >= 0.0 && negativeRange)
+        pixels[i*pixelStride] = upperOutside;
+      else if (value <= 0.0 && !negativeRange)
+        pixels[i*pixelStride] = lowerOutside;
+      else
+        pixels[i*pixelStride] = qLn(value/origin)*factor+base;
+    }
+  }
+}
+
 /*!
   Returns the part of the axis that is hit by \a pos (in pixels). The return value of this function
   is independent of the user-selectable parts defined with \ref setSelectableParts. Further, this
@@ -9178,6 +9604,10 @@ QCP::Interaction QCPAxis::selectionCategory() const
   It is used by QCPAxis to do the low-level drawing of axis backbone, tick marks, tick labels and
   axis label. It also buffers the labels to reduce replot times. The parameters are configured by
   directly accessing the public member variables.
+  
+  The tick label buffers are kept in a cache shared by all axes of all plots (see \ref labelCache),
+  so axes with equal label parameters reuse each other's labels, and labels that scroll out of view
+  and back in aren't created again.
 */
 
 /*!
@@ -9204,8 +9634,7 @@ QCPAxisPainterPrivate::QCPAxisPainterPrivate(QCustomPlot *parentPlot) :
   offset(0),
   abbreviateDecimalPowers(false),
   reversedEndings(false),
-  mParentPlot(parentPlot),
-  mLabelCache(16) // cache at most 16 (tick) labels
+  mParentPlot(parentPlot)
 {
 }
 
@@ -9222,12 +9651,7 @@ QCPAxisPainterPrivate::~QCPAxisPainterPrivate()
 */
 void QCPAxisPainterPrivate::draw(QCPPainter *painter)
 {
-  QByteArray newHash = generateLabelParameterHash();
-  if (newHash != mLabelParameterHash)
-  {
-    mLabelCache.clear();
-    mLabelParameterHash = newHash;
-  }
+  mLabelParameterHash = generateLabelParameterHash(); // labels created with other parameters are kept, since another axis might still use them
   
   QPoint origin;
   switch (type)
@@ -9448,25 +9872,32 @@ int QCPAxisPainterPrivate::size() const
 
 /*! \internal
   
-  Clears the internal label cache. Upon the next \ref draw, all labels will be created new. This
-  method is called automatically in \ref draw, if any parameters have changed that invalidate the
-  cached labels, such as font, color, etc.
+  Removes the labels created with the current label parameters of this axis painter from the shared
+  label cache. Upon the next \ref draw, these labels will be created new. Since the label
+  parameters are part of the cache keys, this isn't necessary when parameters such as font, color,
+  etc. change.
 */
 void QCPAxisPainterPrivate::clearCache()
 {
-  mLabelCache.clear();
+  QCache<QByteArray, CachedLabel> &cache = labelCache();
+  foreach (const QByteArray &key, cache.keys())
+  {
+    if (key.startsWith(mLabelParameterHash))
+      cache.remove(key);
+  }
 }
 
 /*! \internal
   
-  Returns a hash that allows uniquely identifying whether the label parameters have changed such
-  that the cached labels must be refreshed (\ref clearCache). It is used in \ref draw. If the
-  return value of this method hasn't changed since the last redraw, the respective label parameters
-  haven't changed and cached labels may be used.
+  Returns a hash that uniquely identifies the parameters which influence the appearance of cached
+  labels, such as font, color, rotation, device pixel ratio etc. It is used in \ref draw and
+  prefixes the keys of this axis painter's labels in the shared label cache (see \ref
+  labelCacheKey). Labels are thus only reused by axes whose label parameters are equal.
 */
 QByteArray QCPAxisPainterPrivate::generateLabelParameterHash() const
 {
   QByteArray result;
+  result.append(QByteArray::number((int)type)); // the draw offset of cached labels depends on the axis side
   result.append(QByteArray::number(mParentPlot->bufferDevicePixelRatio()));
   result.append(QByteArray::number(tickLabelRotation));
   result.append(QByteArray::number((int)tickLabelSide));
@@ -9474,9 +9905,34 @@ QByteArray QCPAxisPainterPrivate::generateLabelParameterHash() const
   result.append(QByteArray::number((int)numberMultiplyCross));
   result.append(tickLabelColor.name().toLatin1()+QByteArray::number(tickLabelColor.alpha(), 16));
   result.append(tickLabelFont.toString().toLatin1());
+  result.append('\n'); // separates the parameters from the label text in the cache keys
   return result;
 }
 
+/*! \internal
+  
+  Returns the key of the label with \a text in the shared label cache, consisting of the label
+  parameter hash of the last \ref draw and the text itself.
+*/
+QByteArray QCPAxisPainterPrivate::labelCacheKey(const QString &text) const
+{
+  return mLabelParameterHash+text.toUtf8();
+}
+
+/*! \internal
+  
+  Returns the label cache shared by all axis painters. The cost of a cached label is the memory of
+  its pixmap in bytes, and the least recently used labels are evicted when the total exceeds the
+  budget. Keys consist of the label parameters and the text (see \ref labelCacheKey).
+  
+  The cache is only accessed from the GUI thread, where axes are drawn.
+*/
+QCache<QByteArray, QCPAxisPainterPrivate::CachedLabel> &QCPAxisPainterPrivate::labelCache()
+{
+  static QCache<QByteArray, CachedLabel> cache(8*1024*1024); // cost is given in bytes
+  return cache;
+}
+
 /*! \internal
   
   Draws a single tick label with the provided \a painter, utilizing the internal label cache to
@@ -9511,10 +9967,12 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
   }
   if (mParentPlot->plottingHints().testFlag(QCP::phCacheLabels) && !painter->modes().testFlag(QCPPainter::pmNoCaching)) // label caching enabled
   {
-    CachedLabel *cachedLabel = mLabelCache.take(text); // attempt to get label from cache
+    const QByteArray cacheKey = labelCacheKey(text);
+    CachedLabel *cachedLabel = labelCache().object(cacheKey); // attempt to get label from cache
+    CachedLabel *newLabel = 0;
     if (!cachedLabel)  // no cached label existed, create it
     {
-      cachedLabel = new CachedLabel;
+      cachedLabel = newLabel = new CachedLabel;
       TickLabelData labelData = getTickLabelData(painter->font(), text);
       cachedLabel->offset = getTickLabelDrawOffset(labelData)+labelData.rotatedTotalBounds.topLeft();
       if (!qFuzzyCompare(1.0, mParentPlot->bufferDevicePixelRatio()))
@@ -9548,7 +10006,8 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
       painter->drawPixmap(labelAnchor+cachedLabel->offset, cachedLabel->pixmap);
       finalSize = cachedLabel->pixmap.size()/mParentPlot->bufferDevicePixelRatio();
     }
-    mLabelCache.insert(text, cachedLabel); // return label to cache or insert for the first time if newly created
+    if (newLabel) // insert into cache after use, since the cache may delete it right away if the budget is exceeded
+      labelCache().insert(cacheKey, newLabel, newLabel->pixmap.width()*newLabel->pixmap.height()*4);
   } else // label caching disabled, draw text directly on surface:
   {
     TickLabelData labelData = getTickLabelData(painter->font(), text);
@@ -9810,9 +10269,9 @@ void QCPAxisPainterPrivate::getMaxTickLabelSize(const QFont &font, const QString
 {
   // note: this function must return the same tick label sizes as the placeTickLabel function.
   QSize finalSize;
-  if (mParentPlot->plottingHints().testFlag(QCP::phCacheLabels) && mLabelCache.contains(text)) // label caching enabled and have cached label
+  const CachedLabel *cachedLabel = mParentPlot->plottingHints().testFlag(QCP::phCacheLabels) ? labelCache().object(labelCacheKey(text)) : 0;
+  if (cachedLabel) // label caching enabled and have cached label
   {
-    const CachedLabel *cachedLabel = mLabelCache.object(text);
     finalSize = cachedLabel->pixmap.size()/mParentPlot->bufferDevicePixelRatio();
   } else // label caching disabled or no label with this text cached:
   {
@@ -10299,6 +10758,126 @@ void QCPScatterStyle::drawShape(QCPPainter *painter, double x, double y) const
     }
   }
 }
+
+/*!
+  Draws the scatter shape with \a painter at each of the \a positions. Positions with NaN
+  coordinates are skipped.
+
+  When drawing to a raster device, the shape is rendered only once into a sprite image (with the
+  painter's current pen, brush, antialiasing and the device pixel ratio) and then blitted to all
+  positions. This is much faster than filling and stroking a path for every scatter. Sprites are
+  kept in a cache shared by all scatter styles, so consecutive replots reuse them. The sprite is
+  placed on whole device pixels, so scatters may be shifted by up to half a pixel compared to \ref
+  drawShape.
+
+  Vectorized output (e.g. PDF), painters with caching disabled (\ref QCPPainter::pmNoCaching, used
+  for exports), scaled or rotated painters, non-solid pens and brushes, as well as the shapes \ref
+  ssDot, \ref ssPixmap and \ref ssCustom are drawn with \ref drawShape per position instead.
+
+  Like \ref drawShape, this function does not modify the pen or the brush on the painter, \ref
+  applyTo should be called first.
+*/
+void QCPScatterStyle::drawShapes(QCPPainter *painter, const QVector<QPointF> &positions) const
+{
+  if (!canUseSprite(painter))
+  {
+    for (int i=0; i<positions.size(); ++i)
+    {
+      if (!qIsNaN(positions.at(i).x()) && !qIsNaN(positions.at(i).y()))
+        drawShape(painter, positions.at(i));
+    }
+    return;
+  }
+  
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+#  ifdef QCP_DEVICEPIXELRATIO_FLOAT
+  const double devicePixelRatio = painter->device()->devicePixelRatioF();
+#  else
+  const double devicePixelRatio = painter->device()->devicePixelRatio();
+#  endif
+#else
+  const double devicePixelRatio = 1.0;
+#endif
+  const QImage spriteImage = sprite(painter, devicePixelRatio);
+  const double center = spriteImage.width()*0.5; // in device pixels
+  const QTransform transform = painter->transform(); // only a translation, see canUseSprite
+  painter->save();
+  painter->resetTransform(); // draw in device pixels, so the sprite is placed on whole pixels
+  for (int i=0; i<positions.size(); ++i)
+  {
+    if (!qIsNaN(positions.at(i).x()) && !qIsNaN(positions.at(i).y()))
+    {
+      const QPointF devicePos = transform.map(positions.at(i))*devicePixelRatio;
+      painter->drawImage(QPointF(qRound(devicePos.x()-center), qRound(devicePos.y()-center))/devicePixelRatio, spriteImage);
+    }
+  }
+  painter->restore();
+}
+
+/*! \internal
+
+  Returns whether \ref drawShapes may blit a cached sprite of this scatter style with \a painter,
+  see there for the conditions.
+*/
+bool QCPScatterStyle::canUseSprite(const QCPPainter *painter) const
+{
+  if (mShape == ssNone || mShape == ssDot || mShape == ssPixmap || mShape == ssCustom)
+    return false;
+  if (painter->modes().testFlag(QCPPainter::pmVectorized) || painter->modes().testFlag(QCPPainter::pmNoCaching))
+    return false;
+  if (painter->transform().type() > QTransform::TxTranslate)
+    return false;
+  if (painter->pen().brush().style() != Qt::SolidPattern)
+    return false;
+  return painter->brush().style() == Qt::NoBrush || painter->brush().style() == Qt::SolidPattern;
+}
+
+/*! \internal
+
+  Returns the sprite of this scatter style, drawn with the current pen, brush, antialiasing and
+  modes of \a painter at the given \a devicePixelRatio. The shape is centered in the returned
+  image.
+
+  Sprites are cached by all properties that influence their appearance. The cache is shared by all
+  scatter styles and protected by a mutex, since plottables may be drawn on several threads (see
+  \ref QCP::phTiledRaster). For the same reason, sprites are QImages, which unlike QPixmaps may be
+  created and painted outside the GUI thread.
+*/
+QImage QCPScatterStyle::sprite(const QCPPainter *painter, double devicePixelRatio) const
+{
+  static QCache<QString, QImage> spriteCache(4*1024*1024); // cost is given in bytes
+  static QMutex spriteCacheMutex;
+  
+  const QPen pen = painter->pen();
+  const QBrush brush = painter->brush();
+  const QString key = QString(QLatin1String("%1_%2_%3_%4_%5_%6_%7_%8")).arg(mShape).arg(mSize).arg(pen.color().rgba()).arg(pen.widthF())
+      .arg(pen.style()).arg(pen.capStyle()).arg(pen.joinStyle()).arg(pen.isCosmetic())
+      +QString(QLatin1String("_%1_%2_%3_%4_%5")).arg(brush.style()).arg(brush.color().rgba()).arg(devicePixelRatio).arg(painter->antialiasing()).arg(int(painter->modes()));
+  
+  QMutexLocker locker(&spriteCacheMutex);
+  if (QImage *cachedSprite = spriteCache.object(key))
+    return *cachedSprite;
+  
+  // leave room for the pen width and the antialiasing fringe around the shape:
+  const int deviceExtent = qCeil((mSize+qMax(1.0, pen.widthF())+2)*devicePixelRatio);
+  QImage *result = new QImage(deviceExtent, deviceExtent, QImage::Format_ARGB32_Premultiplied);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  result->setDevicePixelRatio(devicePixelRatio);
+#endif
+  result->fill(Qt::transparent);
+  QCPPainter spritePainter(result);
+  spritePainter.setModes(painter->modes());
+  spritePainter.setAntialiasing(painter->antialiasing());
+  spritePainter.setPen(pen);
+  spritePainter.setBrush(brush);
+  const double center = deviceExtent*0.5/devicePixelRatio;
+  drawShape(&spritePainter, center, center);
+  spritePainter.end();
+  
+  const QImage sprite = *result;
+  spriteCache.insert(key, result, deviceExtent*deviceExtent*4);
+  return sprite;
+}
 /* end of 'src/scatterstyle.cpp' */
 
 //amalgamation: add datacontainer.cpp
@@ -10708,7 +11287,8 @@ QCPAbstractPlottable::QCPAbstractPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis)
   mKeyAxis(keyAxis),
   mValueAxis(valueAxis),
   mSelectable(QCP::stWhole),
-  mSelectionDecorator(0)
+  mSelectionDecorator(0),
+  mSpatialIndex(false)
 {
   if (keyAxis->parentPlot() != valueAxis->parentPlot())
     qDebug() << Q_FUNC_INFO << "Parent plot of keyAxis is not the same as that of valueAxis.";
@@ -10900,6 +11480,25 @@ void QCPAbstractPlottable::setSelectable(QCP::SelectionType selectable)
   }
 }
 
+/*!
+  Sets whether this plottable keeps a spatial index of its data in pixel coordinates, to speed up
+  hit tests such as \ref selectTest and rect selection (\ref QCPPlottableInterface1D::selectTestRect).
+  
+  The index sorts the visible data points (and for \ref QCPGraph also the line segments) into
+  buckets of one pixel column along the key axis. It is rebuilt lazily on the first hit test after
+  a replot, which costs one pass over the visible data. Subsequent hit tests until the next replot,
+  e.g. while the mouse is moved for hover tooltips, only look at the few columns around the
+  requested position and run in nearly constant time, independent of the data count.
+  
+  Enabling this only pays off for plottables with many data points that are hit-tested frequently.
+  It is supported by plottables derived from \ref QCPAbstractPlottable1D whose data is sorted by
+  key (e.g. \ref QCPGraph). Other plottables ignore this setting.
+*/
+void QCPAbstractPlottable::setSpatialIndex(bool enabled)
+{
+  mSpatialIndex = enabled;
+}
+
 
 /*!
   Convenience function for transforming a key/value pair to pixels on the QCustomPlot surface,
@@ -10943,6 +11542,35 @@ const QPointF QCPAbstractPlottable::coordsToPixels(double key, double value) con
     return QPointF(valueAxis->coordToPixel(value), keyAxis->coordToPixel(key));
 }
 
+/*! \overload
+
+  Transforms \a count key/value pairs to pixel coordinates and writes them to \a pixels, which must
+  have room for \a count points. The keys and values are read from \a keys and \a values,
+  advancing by \a stride doubles per pair. For an array of data structs like QCPGraphData, pass the
+  addresses of the first key and value and the size of the struct in doubles.
+
+  This uses the batch transform \ref QCPAxis::coordToPixel(const double*, double*, int, int, int) const
+  of the key and value axis, which is considerably faster than transforming each pair individually.
+*/
+void QCPAbstractPlottable::coordsToPixels(const double *keys, const double *values, int count, int stride, QPointF *pixels) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  
+  if (sizeof(qreal) == sizeof(double)) // QPointF is two adjacent doubles, so the axes can write the coordinates in place
+  {
+    double *coords = reinterpret_cast<double*>(pixels);
+    const bool keyHorizontal = keyAxis->orientation() == Qt::Horizontal;
+    keyAxis->coordToPixel(keys, coords+(keyHorizontal ? 0 : 1), count, stride, 2);
+    valueAxis->coordToPixel(values, coords+(keyHorizontal ? 1 : 0), count, stride, 2);
+  } else
+  {
+    for (int i=0; i<count; ++i)
+      pixels[i] = coordsToPixels(keys[i*stride], values[i*stride]);
+  }
+}
+
 /*!
   Convenience function for transforming a x/y pixel pair on the QCustomPlot surface to plot coordinates,
   taking the orientations of the axes associated with this plottable into account (e.g. whether key
@@ -11273,10 +11901,298 @@ void QCPAbstractPlottable::deselectEvent(bool *selectionStateChanged)
       *selectionStateChanged = mSelection != selectionBefore;
   }
 }
-/* end of 'src/plottable.cpp' */
 
-
-/* including file 'src/item.cpp', size 49271                                 */
+/*! \internal
+  
+  Returns the number of replots the parent plot has performed so far. Lazily built pixel data such
+  as the spatial index (\ref setSpatialIndex) is considered outdated when this number changes.
+*/
+int QCPAbstractPlottable::replotCount() const
+{
+  return mParentPlot ? mParentPlot->mReplotCount : 0;
+}
+
+/*! \internal
+  
+  Returns the pixel range covered by the axis rect along the key axis direction. This is the range
+  of key pixel coordinates a \ref QCPPixelColumnIndex of this plottable needs to distinguish.
+*/
+QCPRange QCPAbstractPlottable::keyPixelRange() const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  if (!keyAxis) return QCPRange();
+  const QRect rect = keyAxis->axisRect()->rect();
+  if (keyAxis->orientation() == Qt::Horizontal)
+    return QCPRange(rect.left(), rect.right());
+  else
+    return QCPRange(rect.top(), rect.bottom());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPixelColumnIndex
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPixelColumnIndex
+  \brief A spatial index of pixel positions, bucketed into pixel columns along the key axis
+
+  This class is used by plottables to accelerate hit tests when \ref
+  QCPAbstractPlottable::setSpatialIndex is enabled.
+
+  It holds a sequence of pixel positions which are ordered by key, such that their key pixel
+  coordinate is monotonic (like the data points of a \ref QCPGraph or the points of its line). Each
+  one pixel wide column along the key axis thus maps to a contiguous range of points, and the index
+  only stores where each column begins, plus the pixel extent of its points perpendicular to the key
+  axis. Queries look up the columns in question directly and skip columns whose extent can't
+  contain a closer or enclosed point, so they don't depend on the total number of points.
+*/
+
+/*!
+  Creates an empty index.
+*/
+QCPPixelColumnIndex::QCPPixelColumnIndex() :
+  mKeyOrientation(Qt::Horizontal),
+  mDirection(1),
+  mColumnOrigin(0),
+  mFirstIndex(0),
+  mReplotCount(-1),
+  mDataSource(0),
+  mDataRevision(-1)
+{
+}
+
+/*!
+  Frees the index data. Afterwards, \ref isUpToDate returns false.
+*/
+void QCPPixelColumnIndex::clear()
+{
+  mPoints.clear();
+  mColumnStart.clear();
+  mCrossMin.clear();
+  mCrossMax.clear();
+  mReplotCount = -1;
+  mDataSource = 0;
+  mDataRevision = -1;
+}
+
+/*!
+  Builds the index from \a points, which must be ordered such that their coordinate along the key
+  axis (given by \a keyOrientation) is monotonic. One column is created for each pixel in \a
+  keyPixelRange. Points outside of that range are sorted into the first or last column.
+  
+  Indices returned by the query methods are offset by \a firstIndex, so they refer to the data
+  index of the point rather than its position in \a points. \a replotCount, \a dataSource (the
+  address of the data container) and \a dataRevision (\ref QCPDataContainer::revision) are
+  remembered to tell whether the index is still up to date (see \ref isUpToDate).
+*/
+void QCPPixelColumnIndex::build(const QVector<QPointF> &points, Qt::Orientation keyOrientation, const QCPRange &keyPixelRange, int firstIndex, int replotCount, quintptr dataSource, int dataRevision)
+{
+  mPoints = points;
+  mKeyOrientation = keyOrientation;
+  mFirstIndex = firstIndex;
+  mReplotCount = replotCount;
+  mDataSource = dataSource;
+  mDataRevision = dataRevision;
+  const int pointCount = mPoints.size();
+  mDirection = pointCount > 1 && keyPixel(mPoints.last()) < keyPixel(mPoints.first()) ? -1 : 1;
+  mColumnOrigin = qFloor(qMin(mDirection*keyPixelRange.lower, mDirection*keyPixelRange.upper));
+  const int columnCount = qMax(1, (int)(qMax(mDirection*keyPixelRange.lower, mDirection*keyPixelRange.upper)-mColumnOrigin)+1);
+  mColumnStart.resize(columnCount+1);
+  mCrossMin.fill(std::numeric_limits<double>::infinity(), columnCount);
+  mCrossMax.fill(-std::numeric_limits<double>::infinity(), columnCount);
+  
+  int nextColumn = 0; // the first column whose start isn't known yet
+  int column = 0;
+  for (int i=0; i<pointCount; ++i)
+  {
+    column = qMax(column, columnAt(keyPixel(mPoints.at(i)))); // stay monotonic, even if keys aren't (e.g. NaN keys)
+    while (nextColumn <= column)
+      mColumnStart[nextColumn++] = i;
+    const double cross = crossPixel(mPoints.at(i));
+    if (qIsNaN(cross)) // gaps make the column extent unknown, so it's never skipped or accepted as a whole
+    {
+      mCrossMin[column] = -std::numeric_limits<double>::infinity();
+      mCrossMax[column] = std::numeric_limits<double>::infinity();
+    } else
+    {
+      if (cross < mCrossMin[column])
+        mCrossMin[column] = cross;
+      if (cross > mCrossMax[column])
+        mCrossMax[column] = cross;
+    }
+  }
+  while (nextColumn <= columnCount)
+    mColumnStart[nextColumn++] = pointCount;
+}
+
+/*!
+  Returns the index of the point closest to \a pos, considering only the columns within \a
+  keyTolerance pixels of \a pos along the key axis. The squared pixel distance to the point is
+  written to \a distanceSqr.
+  
+  If there are no points in question, returns -1 and doesn't modify \a distanceSqr.
+*/
+int QCPPixelColumnIndex::nearestPoint(const QPointF &pos, double keyTolerance, double *distanceSqr) const
+{
+  if (mPoints.isEmpty())
+    return -1;
+  int firstColumn, lastColumn;
+  columnsInRange(keyPixel(pos)-keyTolerance, keyPixel(pos)+keyTolerance, firstColumn, lastColumn);
+  const double posCross = crossPixel(pos);
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  int result = -1;
+  for (int column=firstColumn; column<=lastColumn; ++column)
+  {
+    // the distance of the column extent from pos is a lower bound for the distance of its points:
+    const double crossDistance = posCross < mCrossMin.at(column) ? mCrossMin.at(column)-posCross : (posCross > mCrossMax.at(column) ? posCross-mCrossMax.at(column) : 0);
+    if (crossDistance*crossDistance >= minDistSqr)
+      continue;
+    const int end = mColumnStart.at(column+1);
+    for (int i=mColumnStart.at(column); i<end; ++i)
+    {
+      const double currentDistSqr = QCPVector2D(mPoints.at(i)-pos).lengthSquared();
+      if (currentDistSqr < minDistSqr)
+      {
+        minDistSqr = currentDistSqr;
+        result = i;
+      }
+    }
+  }
+  if (result < 0)
+    return -1;
+  if (distanceSqr)
+    *distanceSqr = minDistSqr;
+  return result+mFirstIndex;
+}
+
+/*!
+  Interprets the points as a polyline and returns the smallest squared pixel distance of \a pos to
+  its segments which are within \a keyTolerance pixels of \a pos along the key axis. If \a step
+  is 2, only every other segment starting with the first is considered, as for the pairwise
+  connected points of impulse lines.
+  
+  If there are no segments in question, returns the largest double value.
+*/
+double QCPPixelColumnIndex::segmentDistanceSqr(const QPointF &pos, double keyTolerance, int step) const
+{
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  if (mPoints.size() < 2)
+    return minDistSqr;
+  int firstColumn, lastColumn;
+  columnsInRange(keyPixel(pos)-keyTolerance, keyPixel(pos)+keyTolerance, firstColumn, lastColumn);
+  // include the segments entering the first and leaving the last column, which may cross the
+  // columns in question without having a point in them:
+  int begin = qMax(0, mColumnStart.at(firstColumn)-1);
+  begin -= begin % step;
+  const int end = qMin(mColumnStart.at(lastColumn+1)+1, mPoints.size()-1);
+  const QCPVector2D p(pos);
+  for (int i=begin; i<end; i+=step)
+  {
+    const double currentDistSqr = p.distanceSquaredToLine(mPoints.at(i), mPoints.at(i+1));
+    if (currentDistSqr < minDistSqr)
+      minDistSqr = currentDistSqr;
+  }
+  return minDistSqr;
+}
+
+/*!
+  Returns the indices of the points inside \a rect (including its border) as a data selection.
+  Columns whose points are all inside \a rect are added as a whole, without testing each point.
+*/
+QCPDataSelection QCPPixelColumnIndex::pointsInRect(const QRectF &rect) const
+{
+  QCPDataSelection result;
+  if (mPoints.isEmpty())
+    return result;
+  const QRectF normRect = rect.normalized();
+  int firstColumn, lastColumn;
+  double crossLower, crossUpper;
+  if (mKeyOrientation == Qt::Horizontal)
+  {
+    columnsInRange(normRect.left(), normRect.right(), firstColumn, lastColumn);
+    crossLower = normRect.top();
+    crossUpper = normRect.bottom();
+  } else
+  {
+    columnsInRange(normRect.top(), normRect.bottom(), firstColumn, lastColumn);
+    crossLower = normRect.left();
+    crossUpper = normRect.right();
+  }
+  
+  int currentSegmentBegin = -1; // -1 means we're currently not in a segment that's contained in rect
+  for (int column=firstColumn; column<=lastColumn; ++column)
+  {
+    const int begin = mColumnStart.at(column);
+    const int end = mColumnStart.at(column+1);
+    if (begin == end)
+      continue;
+    if (mCrossMax.at(column) < crossLower || mCrossMin.at(column) > crossUpper) // no point of the column is inside
+    {
+      if (currentSegmentBegin != -1)
+      {
+        result.addDataRange(QCPDataRange(currentSegmentBegin+mFirstIndex, begin+mFirstIndex), false);
+        currentSegmentBegin = -1;
+      }
+    } else if (column > firstColumn && column < lastColumn && mCrossMin.at(column) >= crossLower && mCrossMax.at(column) <= crossUpper) // all points of the column are inside
+    {
+      if (currentSegmentBegin == -1)
+        currentSegmentBegin = begin;
+    } else
+    {
+      for (int i=begin; i<end; ++i)
+      {
+        if (normRect.contains(mPoints.at(i)))
+        {
+          if (currentSegmentBegin == -1)
+            currentSegmentBegin = i;
+        } else if (currentSegmentBegin != -1)
+        {
+          result.addDataRange(QCPDataRange(currentSegmentBegin+mFirstIndex, i+mFirstIndex), false);
+          currentSegmentBegin = -1;
+        }
+      }
+    }
+  }
+  // process potential last segment:
+  if (currentSegmentBegin != -1)
+    result.addDataRange(QCPDataRange(currentSegmentBegin+mFirstIndex, mColumnStart.at(lastColumn+1)+mFirstIndex), false);
+  
+  result.simplify();
+  return result;
+}
+
+/*! \internal
+  
+  Returns the column of the key pixel coordinate \a keyPixel. Coordinates outside the indexed pixel
+  range (and NaN) are mapped to the first or last column.
+*/
+int QCPPixelColumnIndex::columnAt(double keyPixel) const
+{
+  const double column = mDirection*keyPixel-mColumnOrigin;
+  if (!(column > 0)) // also catches NaN
+    return 0;
+  const int lastColumn = mCrossMin.size()-1;
+  if (column >= lastColumn)
+    return lastColumn;
+  return (int)column;
+}
+
+/*! \internal
+  
+  Outputs the first and last column covered by the key pixel coordinates \a keyPixel1 and \a
+  keyPixel2, in either order.
+*/
+void QCPPixelColumnIndex::columnsInRange(double keyPixel1, double keyPixel2, int &firstColumn, int &lastColumn) const
+{
+  firstColumn = columnAt(keyPixel1);
+  lastColumn = columnAt(keyPixel2);
+  if (firstColumn > lastColumn)
+    qSwap(firstColumn, lastColumn);
+}
+/* end of 'src/plottable.cpp' */
+
+
+/* including file 'src/item.cpp', size 49271                                 */
 /* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -12550,6 +13466,176 @@ QCP::Interaction QCPAbstractItem::selectionCategory() const
 /* including file 'src/core.cpp', size 126207                                */
 /* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPRenderSnapshot
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPRenderSnapshot
+  \brief A recorded frame of a QCustomPlot that can be rendered on any thread
+
+  Exporting a plot with \ref QCustomPlot::savePng, \ref QCustomPlot::savePdf etc. rasterizes the
+  complete plot on the GUI thread, which freezes the user interface for large, high resolution
+  exports. A snapshot splits this work: \ref QCustomPlot::snapshot walks the plot once on the GUI
+  thread and records the resulting paint commands (including the current data, axes and styles) in
+  a QPicture. The costly rasterization or PDF generation can then be done with \ref toImage, \ref
+  saveRastered or \ref savePdf on a worker thread, using the raster paint engine and without a
+  display. The snapshot is independent of the plot, so the plot may be changed, replotted or even
+  deleted while the snapshot is being rendered.
+
+  Snapshots are implicitly shared and cheap to copy. The const methods may be called concurrently
+  from several threads, so many snapshots (e.g. of consecutive runs) can be exported in parallel.
+  \ref QCustomPlot::saveInBackground is a convenience method that takes a snapshot and saves it to
+  a file on the global thread pool.
+
+  \note Pixmaps contained in the plot (e.g. axis rect backgrounds or \ref QCPItemPixmap) are drawn
+  from the worker thread, too. This requires a platform that supports threaded pixmaps, which is the
+  case for all common desktop platforms and the offscreen platform.
+*/
+
+/*!
+  Creates a null snapshot. Use \ref QCustomPlot::snapshot to create a snapshot of a plot.
+*/
+QCPRenderSnapshot::QCPRenderSnapshot()
+{
+}
+
+/*!
+  Renders the snapshot to an image and returns it. The image has the size of the snapshot (\ref
+  size), multiplied by \a scale. Like with \ref QCustomPlot::toPixmap, scaling is not done by
+  stretching a small image, the result has full resolution.
+
+  This method may be called from any thread.
+*/
+QImage QCPRenderSnapshot::toImage(double scale) const
+{
+  if (isNull())
+    return QImage();
+  QImage result(qRound(scale*mSize.width()), qRound(scale*mSize.height()), QImage::Format_ARGB32_Premultiplied);
+  if (result.isNull())
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't allocate image of size" << result.size();
+    return QImage();
+  }
+  result.fill(Qt::transparent); // the background of the plot is part of the recorded picture
+  QPainter painter(&result);
+  if (!qFuzzyCompare(scale, 1.0))
+    painter.scale(scale, scale);
+  painter.drawPicture(0, 0, mPicture);
+  painter.end();
+  return result;
+}
+
+/*!
+  Saves the snapshot to a rastered image file \a fileName in the image format \a format. The
+  parameters behave like the ones of \ref QCustomPlot::saveRastered.
+
+  Returns true on success. This method may be called from any thread.
+*/
+bool QCPRenderSnapshot::saveRastered(const QString &fileName, double scale, const char *format, int quality, int resolution, QCP::ResolutionUnit resolutionUnit) const
+{
+  QImage buffer = toImage(scale);
+  
+  int dotsPerMeter = 0;
+  switch (resolutionUnit)
+  {
+    case QCP::ruDotsPerMeter: dotsPerMeter = resolution; break;
+    case QCP::ruDotsPerCentimeter: dotsPerMeter = resolution*100; break;
+    case QCP::ruDotsPerInch: dotsPerMeter = resolution/0.0254; break;
+  }
+  buffer.setDotsPerMeterX(dotsPerMeter); // this is saved together with some image formats, e.g. PNG, and is relevant when opening image in other tools
+  buffer.setDotsPerMeterY(dotsPerMeter); // this is saved together with some image formats, e.g. PNG, and is relevant when opening image in other tools
+  if (!buffer.isNull())
+    return buffer.save(fileName, format, quality);
+  else
+    return false;
+}
+
+/*!
+  Saves the snapshot to a PDF file \a fileName. The page has the size of the snapshot in points.
+  Unlike \ref QCustomPlot::savePdf, this uses QPdfWriter, which doesn't require the print support
+  module and may be called from any thread.
+
+  Returns true on success.
+*/
+bool QCPRenderSnapshot::savePdf(const QString &fileName, const QString &pdfCreator, const QString &pdfTitle) const
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 3, 0)
+  Q_UNUSED(fileName)
+  Q_UNUSED(pdfCreator)
+  Q_UNUSED(pdfTitle)
+  qDebug() << Q_FUNC_INFO << "Saving snapshots as PDF requires Qt 5.3 or higher. PDF not created.";
+  return false;
+#else
+  if (isNull())
+    return false;
+  QPdfWriter writer(fileName);
+  writer.setCreator(pdfCreator);
+  writer.setTitle(pdfTitle);
+  writer.setResolution(mPicture.logicalDpiY()); // same resolution as the picture, so recorded fonts aren't rescaled on playback
+  writer.setPageLayout(QPageLayout(QPageSize(mSize, QPageSize::Point, QString(), QPageSize::ExactMatch), QPageLayout::Portrait, QMarginsF(0, 0, 0, 0)));
+  QPainter painter;
+  if (!painter.begin(&writer))
+    return false;
+  painter.setWindow(QRect(QPoint(0, 0), mSize));
+  painter.drawPicture(0, 0, mPicture);
+  return painter.end();
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPSnapshotSaveTask
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPSnapshotSaveTask
+  \brief Saves a QCPRenderSnapshot to a file on a thread pool
+
+  This task is created and started by \ref QCustomPlot::saveInBackground. It lives in the thread
+  that created it, while \ref run executes on a thread of the pool. When done, the \ref finished
+  signal is emitted (and delivered queued to receivers in other threads) and the task deletes
+  itself.
+
+  The output format is chosen by the suffix of the file name: "pdf" creates a PDF with \ref
+  QCPRenderSnapshot::savePdf, any other suffix is passed to \ref QCPRenderSnapshot::saveRastered as
+  image format.
+*/
+
+/*! \fn void QCPSnapshotSaveTask::finished(const QString &fileName, bool success)
+
+  This signal is emitted from the worker thread after the snapshot was saved to \a fileName.
+  \a success tells whether saving succeeded.
+*/
+
+/*!
+  Creates a task that saves \a snapshot to \a fileName. The other parameters are passed to \ref
+  QCPRenderSnapshot::saveRastered if a rastered image format is written.
+*/
+QCPSnapshotSaveTask::QCPSnapshotSaveTask(const QCPRenderSnapshot &snapshot, const QString &fileName, double scale, int quality, int resolution, QCP::ResolutionUnit resolutionUnit) :
+  QObject(0),
+  mSnapshot(snapshot),
+  mFileName(fileName),
+  mScale(scale),
+  mQuality(quality),
+  mResolution(resolution),
+  mResolutionUnit(resolutionUnit)
+{
+  setAutoDelete(false); // the task is a QObject living in the creating thread, it's deleted with deleteLater in run
+}
+
+/* inherits documentation from base class */
+void QCPSnapshotSaveTask::run()
+{
+  bool success = false;
+  const QString suffix = QFileInfo(mFileName).suffix().toLower();
+  if (suffix == QLatin1String("pdf"))
+    success = mSnapshot.savePdf(mFileName);
+  else
+    success = mSnapshot.saveRastered(mFileName, mScale, suffix.isEmpty() ? "PNG" : suffix.toLatin1().constData(), mQuality, mResolution, mResolutionUnit);
+  emit finished(mFileName, success);
+  deleteLater();
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCustomPlot
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -12741,6 +13827,12 @@ QCP::Interaction QCPAbstractItem::selectionCategory() const
   \see replot, afterReplot
 */
 
+/*! \fn void QCustomPlot::backgroundSaveFinished(const QString &fileName, bool success)
+
+  This signal is emitted when a file started with \ref saveInBackground was written to \a
+  fileName. \a success tells whether saving succeeded.
+*/
+
 /*! \fn void QCustomPlot::afterReplot()
   
   This signal is emitted immediately after a replot has taken place (caused by a call to the slot \ref
@@ -12880,14 +13972,18 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mSelectionRectMode(QCP::srmNone),
   mSelectionRect(0),
   mOpenGl(false),
+  mExportResolution(0),
   mMouseHasMoved(false),
   mMouseEventLayerable(0),
   mMouseSignalLayerable(0),
   mReplotting(false),
   mReplotQueued(false),
+  mFullReplotRequested(true),
+  mReplotCount(0),
   mOpenGlMultisamples(16),
   mOpenGlAntialiasedElementsBackup(QCP::aeNone),
-  mOpenGlCacheLabelsBackup(true)
+  mOpenGlCacheLabelsBackup(true),
+  mPlotGroup(0)
 {
   setAttribute(Qt::WA_NoMousePropagation);
   setAttribute(Qt::WA_OpaquePaintEvent);
@@ -12955,6 +14051,11 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
 
 QCustomPlot::~QCustomPlot()
 {
+  if (mPlotGroup)
+  {
+    mPlotGroup->mPendingPlots.removeAll(this);
+    mPlotGroup->removePlot(this);
+  }
   clearPlottables();
   clearItems();
 
@@ -13363,6 +14464,27 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
 #endif
 }
 
+/*!
+  Sets the resolution in dots per inch at which vector exports (\ref savePdf, or \ref toPainter
+  with a painter in \ref QCPPainter::pmVectorized mode) are expected to be viewed or printed.
+  
+  If \a dpi is greater than zero, graphs are decimated for this resolution when drawn to a vector
+  format, instead of using the adaptive sampling of the screen (see \ref
+  QCPGraph::setAdaptiveSampling). For every device dot along the key axis, only the first, the last,
+  the minimum and the maximum data point are kept. The resulting line is then simplified with the
+  Douglas-Peucker algorithm, with a tolerance of half a device dot. The exported line can't be
+  distinguished from the full data at the target resolution, while long recordings with millions
+  of points result in small files that render quickly.
+  
+  As in \ref savePdf, one pixel of the plot is taken to be one point (1/72 inch) of the exported page.
+  
+  The default of 0 disables the decimation, so vector exports use the regular adaptive sampling.
+*/
+void QCustomPlot::setExportResolution(int dpi)
+{
+  mExportResolution = qMax(0, dpi);
+}
+
 /*!
   Sets the viewport of this QCustomPlot. Usually users of QCustomPlot don't need to change the
   viewport manually.
@@ -14419,11 +15541,27 @@ void QCustomPlot::deselectAll()
   If a layer is in mode \ref QCPLayer::lmBuffered (\ref QCPLayer::setMode), it is also possible to
   replot only that specific layer via \ref QCPLayer::replot. See the documentation there for
   details.
+
+  If this plot is a member of a \ref QCPPlotGroup, a replot with \ref rpQueuedReplot priority is
+  queued by the group, so it happens in the same frame as the queued replots of the other plots in
+  the group (see \ref QCPPlotGroup::queueReplot).
+
+  If the plotting hint \ref QCP::phDirtyLayerReplot is set and neither the viewport, the layout nor
+  any axis range changed since the previous replot, only the paint buffers holding layers marked
+  dirty (\ref QCPLayer::markDirty) are cleared and redrawn. The other buffers are composited from
+  their previous contents. User interactions like selection always cause a complete replot. Axis
+  rects in strip chart mode additionally allow their horizontal axes to scroll, see \ref
+  QCPAxisRect::setStripChart.
 */
 void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
 {
   if (refreshPriority == QCustomPlot::rpQueuedReplot)
   {
+    if (mPlotGroup)
+    {
+      mPlotGroup->queueReplot(this);
+      return;
+    }
     if (!mReplotQueued)
     {
       mReplotQueued = true;
@@ -14436,15 +15574,60 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
     return;
   mReplotting = true;
   mReplotQueued = false;
+  if (mPlotGroup) // a replot queued by the group would be redundant now
+    mPlotGroup->mPendingPlots.removeAll(this);
   emit beforeReplot();
   
   updateLayout();
-  // draw all layered objects (grid, axes, plottables, items, legend,...) into their buffers:
-  setupPaintBuffers();
+  QVector<double> stripChartZoom;
+  const QVector<double> state = replotState(&stripChartZoom);
+  if (mPlottingHints.testFlag(QCP::phDirtyLayerReplot) && !mFullReplotRequested && !replotStateChanged(state, stripChartZoom) && !mPaintBuffers.isEmpty() && !hasInvalidatedPaintBuffers())
+  {
+    // only redraw buffers that hold dirty layers or were scrolled, the others still contain the previous frame:
+    foreach (QCPAbstractPlottable *plottable, mPlottables)
+    {
+      if (QCPColorMap *colorMap = qobject_cast<QCPColorMap*>(plottable))
+      {
+        if (colorMap->mapImageOutdated())
+          colorMap->markLayerDirty();
+      }
+    }
+    QSet<QCPAbstractPaintBuffer*> dirtyBuffers;
+    QHash<QCPAbstractPaintBuffer*, QRect> exposedRects;
+    foreach (QCPLayer *layer, mLayers)
+    {
+      if (layer->mDirty && !layer->mPaintBuffer.isNull())
+        dirtyBuffers.insert(layer->mPaintBuffer.data());
+    }
+    scrollStripCharts(dirtyBuffers, exposedRects);
+    foreach (QCPAbstractPaintBuffer *buffer, dirtyBuffers)
+      buffer->clear(Qt::transparent);
+    foreach (QCPLayer *layer, mLayers)
+    {
+      if (layer->mPaintBuffer.isNull())
+        continue;
+      if (dirtyBuffers.contains(layer->mPaintBuffer.data()))
+        layer->drawToPaintBuffer();
+      else if (exposedRects.contains(layer->mPaintBuffer.data()))
+        layer->drawToPaintBuffer(exposedRects.value(layer->mPaintBuffer.data()));
+    }
+  } else
+  {
+    // draw all layered objects (grid, axes, plottables, items, legend,...) into their buffers:
+    setupPaintBuffers();
+    foreach (QCPLayer *layer, mLayers)
+      layer->drawToPaintBuffer();
+    mStripChartErrors.clear();
+  }
   foreach (QCPLayer *layer, mLayers)
-    layer->drawToPaintBuffer();
+    layer->mDirty = false;
   for (int i=0; i<mPaintBuffers.size(); ++i)
     mPaintBuffers.at(i)->setInvalidated(false);
+  mReplotState = state;
+  mReplotStripChartZoom = stripChartZoom;
+  mFullReplotRequested = false;
+  ++mReplotCount;
+  updateStripChartLowers();
   
   if ((refreshPriority == rpRefreshHint && mPlottingHints.testFlag(QCP::phImmediateRefresh)) || refreshPriority==rpImmediateRefresh)
     repaint();
@@ -14489,6 +15672,9 @@ void QCustomPlot::rescaleAxes(bool onlyVisiblePlottables)
   selected objects to be painted in their selected look, deselect everything with \ref deselectAll
   before calling this function.
 
+  To keep PDFs of graphs with very many data points small, set the resolution the PDF is intended
+  for with \ref setExportResolution. Graphs are then decimated for that resolution.
+
   Returns true on success.
 
   \warning
@@ -14782,6 +15968,7 @@ void QCustomPlot::resizeEvent(QResizeEvent *event)
 void QCustomPlot::mouseDoubleClickEvent(QMouseEvent *event)
 {
   emit mouseDoubleClick(event);
+  mFullReplotRequested = true; // selection may change, which isn't tracked by dirty layers
   mMouseHasMoved = false;
   mMousePressPos = event->pos();
   
@@ -14913,6 +16100,7 @@ void QCustomPlot::mouseMoveEvent(QMouseEvent *event)
 void QCustomPlot::mouseReleaseEvent(QMouseEvent *event)
 {
   emit mouseRelease(event);
+  mFullReplotRequested = true; // selection may change, which isn't tracked by dirty layers
   
   if (!mMouseHasMoved) // mouse hasn't moved (much) between press and release, so handle as click
   {
@@ -15171,30 +16359,216 @@ bool QCustomPlot::hasInvalidatedPaintBuffers()
 
 /*! \internal
 
-  When \ref setOpenGl is set to true, this method is used to initialize OpenGL (create a context,
-  surface, paint device).
-
-  Returns true on success.
+  Returns a compact description of everything that affects the drawing of all layers at once: the
+  viewport, the buffer device pixel ratio, the outer and inner rects of all axis rects, and the
+  range, scale type, orientation and visibility of all their axes.
 
-  If this method is successful, all paint buffers should be deleted and then reallocated by calling
-  \ref setupPaintBuffers, so the OpenGL-based paint buffer subclasses (\ref
-  QCPPaintBufferGlPbuffer, \ref QCPPaintBufferGlFbo) are used for subsequent replots.
+  The horizontal axes of strip charts (\ref QCPAxisRect::setStripChart) may scroll without a full
+  replot, so only their zoom matters. It isn't part of the returned state, but is written to \a
+  stripChartZoom as pairs of the pixels per unit (per factor of e for logarithmic axes) and the
+  axis length in pixels.
 
-  \see freeOpenGl
+  \ref replot compares this to the state of the previous replot, to decide whether a partial replot
+  of only the dirty layers is possible (see \ref QCP::phDirtyLayerReplot).
 */
-bool QCustomPlot::setupOpenGl()
+QVector<double> QCustomPlot::replotState(QVector<double> *stripChartZoom) const
 {
-#ifdef QCP_OPENGL_FBO
-  freeOpenGl();
-  QSurfaceFormat proposedSurfaceFormat;
-  proposedSurfaceFormat.setSamples(mOpenGlMultisamples);
-#ifdef QCP_OPENGL_OFFSCREENSURFACE
-  QOffscreenSurface *surface = new QOffscreenSurface;
-#else
-  QWindow *surface = new QWindow;
-  surface->setSurfaceType(QSurface::OpenGLSurface);
-#endif
-  surface->setFormat(proposedSurfaceFormat);
+  QVector<double> result;
+  result << mViewport.x() << mViewport.y() << mViewport.width() << mViewport.height() << mBufferDevicePixelRatio;
+  foreach (QCPAxisRect *rect, axisRects())
+  {
+    result << rect->outerRect().x() << rect->outerRect().y() << rect->outerRect().width() << rect->outerRect().height();
+    result << rect->left() << rect->top() << rect->width() << rect->height();
+    foreach (QCPAxis *axis, rect->axes())
+    {
+      if (rect->stripChart() && axis->orientation() == Qt::Horizontal) // strip charts may scroll horizontally, only the zoom matters (see scrollStripCharts)
+      {
+        const double rangeSize = axis->scaleType() == QCPAxis::stLogarithmic ? qLn(axis->range().upper/axis->range().lower) : axis->range().size();
+        *stripChartZoom << rect->width()/rangeSize << rect->width();
+      } else
+        result << axis->range().lower << axis->range().upper;
+      result << axis->scaleType() << axis->rangeReversed() << axis->visible();
+    }
+  }
+  return result;
+}
+
+/*! \internal
+
+  Returns whether \a state and \a stripChartZoom, as returned by \ref replotState, differ from the
+  state of the previous replot.
+
+  The state is compared exactly. The zoom of strip charts is compared with a sub-pixel tolerance,
+  because the range size of a scrolled axis changes slightly due to floating point rounding. It
+  counts as changed when it would shift the pixel position of a coordinate by more than a hundredth
+  of a pixel across the axis.
+*/
+bool QCustomPlot::replotStateChanged(const QVector<double> &state, const QVector<double> &stripChartZoom) const
+{
+  if (state != mReplotState || stripChartZoom.size() != mReplotStripChartZoom.size())
+    return true;
+  for (int i=0; i<stripChartZoom.size(); i+=2)
+  {
+    const double pixelsPerUnit = stripChartZoom.at(i);
+    const double previousPixelsPerUnit = mReplotStripChartZoom.at(i);
+    const double axisLength = stripChartZoom.at(i+1);
+    if (!(qAbs(pixelsPerUnit-previousPixelsPerUnit) <= 0.01*qAbs(previousPixelsPerUnit)/axisLength)) // negated, so NaN counts as changed
+      return true;
+  }
+  return false;
+}
+
+/*! \internal
+
+  Handles axis rects in strip chart mode (\ref QCPAxisRect::setStripChart) during a partial replot.
+
+  For each such axis rect, the distance the horizontal axes scrolled since the previous replot is
+  determined. If any axis rect has scrolled, all paint buffers are added to \a redrawBuffers, since
+  grid, axes and items move along. Exceptions are the dedicated buffers of layers that only hold
+  plottables of an axis rect that scrolled uniformly by less than its width: their contents are
+  scrolled by the same distance, and the exposed strip that needs to be redrawn is stored in \a
+  exposedRects instead.
+*/
+void QCustomPlot::scrollStripCharts(QSet<QCPAbstractPaintBuffer*> &redrawBuffers, QHash<QCPAbstractPaintBuffer*, QRect> &exposedRects)
+{
+  const int stripMargin = 16; // logical pixels redrawn in addition to the exposed strip, for line joins and scatters reaching over its border
+  QList<QCPAxisRect*> scrolledRects;
+  QList<int> deviceShifts;
+  bool anyScrolled = false;
+  foreach (QCPAxisRect *rect, axisRects())
+  {
+    if (!rect->stripChart())
+      continue;
+    // determine by how many pixels the contents moved horizontally since the last replot:
+    bool scrolled = false;
+    bool uniform = true;
+    bool haveShift = false;
+    double shift = 0;
+    foreach (QCPAxis *axis, rect->axes(QCPAxis::atBottom|QCPAxis::atTop))
+    {
+      if (!mStripChartLowers.contains(axis))
+      {
+        scrolled = true;
+        uniform = false;
+        continue;
+      }
+      const double previousLower = mStripChartLowers.value(axis);
+      double axisShift = 0;
+      if (previousLower != axis->range().lower)
+      {
+        scrolled = true;
+        axisShift = axis->coordToPixel(previousLower)-axis->coordToPixel(axis->range().lower);
+      }
+      if (!haveShift)
+      {
+        shift = axisShift;
+        haveShift = true;
+      } else if (qAbs(axisShift-shift) > 0.01)
+        uniform = false;
+    }
+    if (!scrolled)
+      continue;
+    anyScrolled = true;
+    
+    // the buffer can only be moved by whole device pixels, keep track of the accumulated rounding error:
+    const int deviceShift = qRound(shift*mBufferDevicePixelRatio);
+    const double error = mStripChartErrors.value(rect)+shift-deviceShift/mBufferDevicePixelRatio;
+    if (!uniform || qAbs(shift) >= rect->width() || qAbs(error) > 0.5)
+    {
+      mStripChartErrors.remove(rect);
+      continue;
+    }
+    mStripChartErrors.insert(rect, error);
+    scrolledRects.append(rect);
+    deviceShifts.append(deviceShift);
+  }
+  if (!anyScrolled)
+    return;
+  
+  for (int i=0; i<mPaintBuffers.size(); ++i)
+    redrawBuffers.insert(mPaintBuffers.at(i).data());
+  foreach (QCPLayer *layer, mLayers)
+  {
+    if (layer->mode() != QCPLayer::lmBuffered || layer->mPaintBuffer.isNull() || layer->children().isEmpty())
+      continue;
+    // layer must only hold plottables that are keyed on the horizontal axes of the same scrolled axis rect:
+    int rectIndex = -1;
+    foreach (QCPLayerable *child, layer->children())
+    {
+      QCPAbstractPlottable *plottable = qobject_cast<QCPAbstractPlottable*>(child);
+      QCPAxis *keyAxis = plottable ? plottable->keyAxis() : 0;
+      const int index = keyAxis && keyAxis->orientation() == Qt::Horizontal ? scrolledRects.indexOf(keyAxis->axisRect()) : -1;
+      if (index < 0 || (rectIndex >= 0 && index != rectIndex))
+      {
+        rectIndex = -1;
+        break;
+      }
+      rectIndex = index;
+    }
+    if (rectIndex < 0)
+      continue;
+    
+    QCPAxisRect *rect = scrolledRects.at(rectIndex);
+    const int deviceShift = deviceShifts.at(rectIndex);
+    QCPAbstractPaintBuffer *buffer = layer->mPaintBuffer.data();
+    const QRect plotRect = rect->rect().translated(0, -1); // plottables are clipped to this rect, see QCPLayer::draw
+    if (!buffer->scroll(deviceShift, 0, plotRect))
+      continue;
+    const int stripWidth = qCeil(qAbs(deviceShift)/mBufferDevicePixelRatio)+stripMargin;
+    QRect exposedRect = plotRect;
+    if (deviceShift < 0) // contents moved left, new data appears on the right
+      exposedRect.setLeft(qMax(plotRect.left(), plotRect.right()-stripWidth));
+    else
+      exposedRect.setRight(qMin(plotRect.right(), plotRect.left()+stripWidth));
+    redrawBuffers.remove(buffer);
+    exposedRects.insert(buffer, exposedRect);
+  }
+}
+
+/*! \internal
+
+  Stores the current lower range bounds of the horizontal axes of all axis rects in strip chart
+  mode, so the next replot can determine how far they scrolled (see \ref scrollStripCharts).
+*/
+void QCustomPlot::updateStripChartLowers()
+{
+  mStripChartLowers.clear();
+  foreach (QCPAxisRect *rect, axisRects())
+  {
+    if (rect->stripChart())
+    {
+      foreach (QCPAxis *axis, rect->axes(QCPAxis::atBottom|QCPAxis::atTop))
+        mStripChartLowers.insert(axis, axis->range().lower);
+    }
+  }
+}
+
+/*! \internal
+
+  When \ref setOpenGl is set to true, this method is used to initialize OpenGL (create a context,
+  surface, paint device).
+
+  Returns true on success.
+
+  If this method is successful, all paint buffers should be deleted and then reallocated by calling
+  \ref setupPaintBuffers, so the OpenGL-based paint buffer subclasses (\ref
+  QCPPaintBufferGlPbuffer, \ref QCPPaintBufferGlFbo) are used for subsequent replots.
+
+  \see freeOpenGl
+*/
+bool QCustomPlot::setupOpenGl()
+{
+#ifdef QCP_OPENGL_FBO
+  freeOpenGl();
+  QSurfaceFormat proposedSurfaceFormat;
+  proposedSurfaceFormat.setSamples(mOpenGlMultisamples);
+#ifdef QCP_OPENGL_OFFSCREENSURFACE
+  QOffscreenSurface *surface = new QOffscreenSurface;
+#else
+  QWindow *surface = new QWindow;
+  surface->setSurfaceType(QSurface::OpenGLSurface);
+#endif
+  surface->setFormat(proposedSurfaceFormat);
   surface->create();
   mGlSurface = QSharedPointer<QSurface>(surface);
   mGlContext = QSharedPointer<QOpenGLContext>(new QOpenGLContext);
@@ -15741,138 +17115,581 @@ void QCustomPlot::toPainter(QCPPainter *painter, int width, int height)
   } else
     qDebug() << Q_FUNC_INFO << "Passed painter is not active";
 }
-/* end of 'src/core.cpp' */
 
-//amalgamation: add plottable1d.cpp
+/*!
+  Records the plot into a \ref QCPRenderSnapshot and returns it. The snapshot can then be rendered
+  to an image or PDF on a worker thread, see the \ref QCPRenderSnapshot documentation.
 
-/* including file 'src/colorgradient.cpp', size 25342                        */
-/* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
+  The plot is sized to \a width and \a height in pixels. If either is zero, the current size of the
+  widget is used. Only walking the plot and recording the paint commands happens on the calling
+  thread, which is considerably cheaper than rasterizing it. Data reduction of the plottables
+  (adaptive sampling) is done at this logical size, just like \ref toPixmap does.
+
+  Since snapshots are usually rendered scaled up, \a exportPen defaults to \ref QCP::epNoCosmetic,
+  so cosmetic pens scale with the output like they do in \ref toPixmap with a scale larger than 1.
+
+  \see saveInBackground
+*/
+QCPRenderSnapshot QCustomPlot::snapshot(int width, int height, QCP::ExportPen exportPen)
+{
+  QCPRenderSnapshot result;
+  int newWidth, newHeight;
+  if (width == 0 || height == 0)
+  {
+    newWidth = this->width();
+    newHeight = this->height();
+  } else
+  {
+    newWidth = width;
+    newHeight = height;
+  }
+  
+  QCPPainter painter;
+  if (painter.begin(&result.mPicture))
+  {
+    painter.setMode(QCPPainter::pmNonCosmetic, exportPen==QCP::epNoCosmetic);
+    toPainter(&painter, newWidth, newHeight);
+    painter.end();
+    result.mPicture.setBoundingRect(QRect(0, 0, newWidth, newHeight));
+    result.mSize = QSize(newWidth, newHeight);
+  } else
+    qDebug() << Q_FUNC_INFO << "Couldn't activate painter on picture";
+  return result;
+}
+
+/*!
+  Saves the plot to the file \a fileName without blocking the calling thread for the rendering.
+
+  A \ref snapshot of the plot is taken immediately, then it is rendered and written on a thread of
+  the global QThreadPool. Several calls are executed in parallel, which makes this suitable for
+  batch exports. Once the file is written, the signal \ref backgroundSaveFinished is emitted.
+
+  The format is chosen by the suffix of \a fileName: "pdf" creates a PDF, other suffixes (e.g.
+  "png", "jpg", "bmp") are used as image format. The parameters \a width, \a height, \a scale, \a
+  quality, \a resolution and \a resolutionUnit behave like the ones of \ref saveRastered.
+
+  \see QCPSnapshotSaveTask
+*/
+void QCustomPlot::saveInBackground(const QString &fileName, int width, int height, double scale, int quality, int resolution, QCP::ResolutionUnit resolutionUnit)
+{
+  const bool pdf = QFileInfo(fileName).suffix().toLower() == QLatin1String("pdf");
+  QCPSnapshotSaveTask *task = new QCPSnapshotSaveTask(snapshot(width, height, pdf || scale <= 1.0 ? QCP::epAllowCosmetic : QCP::epNoCosmetic), fileName, scale, quality, resolution, resolutionUnit);
+  connect(task, SIGNAL(finished(QString,bool)), this, SIGNAL(backgroundSaveFinished(QString,bool)));
+  QThreadPool::globalInstance()->start(task);
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPColorGradient
+//////////////////// QCPPlotGroup
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/*! \class QCPColorGradient
-  \brief Defines a color gradient for use with e.g. \ref QCPColorMap
+/*! \class QCPPlotGroup
+  \brief Synchronizes the replots and axis ranges of several QCustomPlot instances
   
-  This class describes a color gradient which can be used to encode data with color. For example,
-  QCPColorMap and QCPColorScale have \ref QCPColorMap::setGradient "setGradient" methods which
-  take an instance of this class. Colors are set with \ref setColorStopAt(double position, const QColor &color)
-  with a \a position from 0 to 1. In between these defined color positions, the
-  color will be interpolated linearly either in RGB or HSV space, see \ref setColorInterpolation.
+  Dashboards often show several QCustomPlot widgets side by side, e.g. one per data source, with
+  time axes that should always show the same range. Replotting each plot independently then causes
+  one event loop pass per plot, and connecting the \ref QCPAxis::rangeChanged signals of all axes
+  mutually causes a cascade of signals for every range change.
+  
+  A QCPPlotGroup solves this. Add the plots with \ref addPlot. While a plot is a member, its queued
+  replots (\ref QCustomPlot::replot with \ref QCustomPlot::rpQueuedReplot, which QCustomPlot also
+  uses for its own user interactions) are collected by the group. All plots that requested a
+  replot are then replotted in one pass, at the next frame tick. The plots repaint their widget
+  surfaces with queued refreshes, so Qt combines them into a single paint pass. The frame tick can
+  be throttled with \ref setFrameInterval.
+  
+  Axes of the member plots can be linked with \ref linkAxis. When the range of a linked axis
+  changes, the group sets the same range on all other linked axes and queues the replot of their
+  plots. Each range change is forwarded only once, no matter how many axes are linked.
+  
+  Data can be displayed in several plots without copying it, by sharing the data container of a
+  graph. \ref addSharedGraph creates a graph in another plot which shows the data of a source
+  graph. Data added to the source graph then appears in both plots.
+  
+  A plot can be a member of only one group at a time. The group doesn't take ownership of the
+  plots. Deleting a plot removes it from its group automatically.
+*/
 
-  Alternatively, load one of the preset color gradients shown in the image below, with \ref
-  loadPreset, or by directly specifying the preset in the constructor.
+/* start documentation of signals */
+
+/*! \fn void QCPPlotGroup::beforeReplot()
   
-  Apart from red, green and blue components, the gradient also interpolates the alpha values of the
-  configured color stops. This allows to display some portions of the data range as transparent in
-  the plot.
+  This signal is emitted before the group replots its member plots. The member plots additionally
+  emit their own \ref QCustomPlot::beforeReplot signals.
   
-  \image html QCPColorGradient.png
+  \see replot, afterReplot
+*/
+
+/*! \fn void QCPPlotGroup::afterReplot()
   
-  The \ref QCPColorGradient(GradientPreset preset) constructor allows directly converting a \ref
-  GradientPreset to a QCPColorGradient. This means that you can directly pass \ref GradientPreset
-  to all the \a setGradient methods, e.g.:
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpcolorgradient-setgradient
+  This signal is emitted after the group has replotted its member plots.
   
-  The total number of levels used in the gradient can be set with \ref setLevelCount. Whether the
-  color gradient shall be applied periodically (wrapping around) to data values that lie outside
-  the data range specified on the plottable instance can be controlled with \ref setPeriodic.
+  \see replot, beforeReplot
 */
 
-/*!
-  Constructs a new, empty QCPColorGradient with no predefined color stops. You can add own color
-  stops with \ref setColorStopAt.
+/* end documentation of signals */
 
-  The color level count is initialized to 350.
+/*!
+  Creates an empty plot group. Add plots to it with \ref addPlot.
 */
-QCPColorGradient::QCPColorGradient() :
-  mLevelCount(350),
-  mColorInterpolation(ciRGB),
-  mPeriodic(false),
-  mColorBufferInvalidated(true)
+QCPPlotGroup::QCPPlotGroup(QObject *parent) :
+  QObject(parent),
+  mFrameInterval(0),
+  mSyncingRanges(false)
 {
-  mColorBuffer.fill(qRgb(0, 0, 0), mLevelCount);
+  mFrameTimer.setSingleShot(true);
+  connect(&mFrameTimer, SIGNAL(timeout()), this, SLOT(processQueuedReplots()));
 }
 
-/*!
-  Constructs a new QCPColorGradient initialized with the colors and color interpolation according
-  to \a preset.
+QCPPlotGroup::~QCPPlotGroup()
+{
+  for (int i=0; i<mPlots.size(); ++i)
+  {
+    if (mPlots.at(i))
+      mPlots.at(i)->mPlotGroup = 0;
+  }
+  // hand the replots which are still pending back to the plots:
+  for (int i=0; i<mPendingPlots.size(); ++i)
+  {
+    if (mPendingPlots.at(i))
+      mPendingPlots.at(i)->replot(QCustomPlot::rpQueuedReplot);
+  }
+}
 
-  The color level count is initialized to 350.
+/*!
+  Sets the minimum time in milliseconds between two replots of the group. Replots requested in
+  between are collected and executed together at the next frame tick.
+  
+  The default of 0 replots in the next event loop iteration, like \ref QCustomPlot::rpQueuedReplot
+  does for a single plot. A larger interval limits the frame rate of a dashboard that receives new
+  data at a high rate, e.g. 16 ms for roughly 60 frames per second.
 */
-QCPColorGradient::QCPColorGradient(GradientPreset preset) :
-  mLevelCount(350),
-  mColorInterpolation(ciRGB),
-  mPeriodic(false),
-  mColorBufferInvalidated(true)
+void QCPPlotGroup::setFrameInterval(int msec)
 {
-  mColorBuffer.fill(qRgb(0, 0, 0), mLevelCount);
-  loadPreset(preset);
+  mFrameInterval = qMax(0, msec);
 }
 
-/* undocumented operator */
-bool QCPColorGradient::operator==(const QCPColorGradient &other) const
+/*!
+  Returns the plots that are currently members of this group.
+  
+  \see addPlot, removePlot
+*/
+QList<QCustomPlot*> QCPPlotGroup::plots() const
 {
-  return ((other.mLevelCount == this->mLevelCount) &&
-          (other.mColorInterpolation == this->mColorInterpolation) &&
-          (other.mPeriodic == this->mPeriodic) &&
-          (other.mColorStops == this->mColorStops));
+  QList<QCustomPlot*> result;
+  for (int i=0; i<mPlots.size(); ++i)
+  {
+    if (mPlots.at(i))
+      result.append(mPlots.at(i).data());
+  }
+  return result;
 }
 
 /*!
-  Sets the number of discretization levels of the color gradient to \a n. The default is 350 which
-  is typically enough to create a smooth appearance. The minimum number of levels is 2.
+  Returns whether \a plot is a member of this group.
+*/
+bool QCPPlotGroup::hasPlot(QCustomPlot *plot) const
+{
+  return plot && plot->mPlotGroup == this;
+}
 
-  \image html QCPColorGradient-levelcount.png
+/*!
+  Adds \a plot to this group. Its queued replots are then coalesced with the ones of the other
+  member plots, and its axes can be linked with \ref linkAxis.
+  
+  Returns false if \a plot is zero or already a member of a group.
+  
+  \see removePlot
 */
-void QCPColorGradient::setLevelCount(int n)
+bool QCPPlotGroup::addPlot(QCustomPlot *plot)
 {
-  if (n < 2)
+  if (!plot)
   {
-    qDebug() << Q_FUNC_INFO << "n must be greater or equal 2 but was" << n;
-    n = 2;
+    qDebug() << Q_FUNC_INFO << "passed plot is zero";
+    return false;
   }
-  if (n != mLevelCount)
+  if (plot->mPlotGroup)
   {
-    mLevelCount = n;
-    mColorBufferInvalidated = true;
+    qDebug() << Q_FUNC_INFO << "plot is already a member of a plot group:" << reinterpret_cast<quintptr>(plot);
+    return false;
   }
+  
+  plot->mPlotGroup = this;
+  mPlots.append(plot);
+  return true;
 }
 
 /*!
-  Sets at which positions from 0 to 1 which color shall occur. The positions are the keys, the
-  colors are the values of the passed QMap \a colorStops. In between these color stops, the color
-  is interpolated according to \ref setColorInterpolation.
+  Removes \a plot from this group. Axes of \a plot that were linked are unlinked, and a pending
+  replot of \a plot is handed back to the plot itself.
   
-  A more convenient way to create a custom gradient may be to clear all color stops with \ref
-  clearColorStops (or creating a new, empty QCPColorGradient) and then adding them one by one with
-  \ref setColorStopAt.
+  Returns false if \a plot isn't a member of this group.
   
-  \see clearColorStops
+  \see addPlot
 */
-void QCPColorGradient::setColorStops(const QMap<double, QColor> &colorStops)
+bool QCPPlotGroup::removePlot(QCustomPlot *plot)
 {
-  mColorStops = colorStops;
-  mColorBufferInvalidated = true;
+  if (!hasPlot(plot))
+  {
+    qDebug() << Q_FUNC_INFO << "plot isn't a member of this plot group:" << reinterpret_cast<quintptr>(plot);
+    return false;
+  }
+  
+  for (int i=mLinkedAxes.size()-1; i>=0; --i)
+  {
+    if (mLinkedAxes.at(i) && mLinkedAxes.at(i)->parentPlot() == plot)
+      unlinkAxis(mLinkedAxes.at(i).data());
+  }
+  plot->mPlotGroup = 0;
+  mPlots.removeAll(plot);
+  if (mPendingPlots.removeAll(plot) > 0)
+    plot->replot(QCustomPlot::rpQueuedReplot);
+  return true;
 }
 
 /*!
-  Sets the \a color the gradient will have at the specified \a position (from 0 to 1). In between
-  these color stops, the color is interpolated according to \ref setColorInterpolation.
+  Returns the axes whose ranges are currently synchronized by this group.
   
-  \see setColorStops, clearColorStops
+  \see linkAxis, unlinkAxis
 */
-void QCPColorGradient::setColorStopAt(double position, const QColor &color)
+QList<QCPAxis*> QCPPlotGroup::linkedAxes() const
 {
-  mColorStops.insert(position, color);
-  mColorBufferInvalidated = true;
+  QList<QCPAxis*> result;
+  for (int i=0; i<mLinkedAxes.size(); ++i)
+  {
+    if (mLinkedAxes.at(i))
+      result.append(mLinkedAxes.at(i).data());
+  }
+  return result;
 }
 
 /*!
-  Sets whether the colors in between the configured color stops (see \ref setColorStopAt) shall be
-  interpolated linearly in RGB or in HSV color space.
+  Links the range of \a axis with the ranges of the other linked axes of this group. \a axis
+  immediately takes over the range of the axes that were linked before. From then on, a range change
+  of any linked axis, e.g. by user interaction or \ref QCPAxis::setRange, is applied to all other
+  linked axes, and their plots are replotted in the next frame of the group.
+  
+  The parent plot of \a axis must be a member of this group. Returns false if it isn't, or if \a
+  axis is already linked.
+  
+  \see unlinkAxis
+*/
+bool QCPPlotGroup::linkAxis(QCPAxis *axis)
+{
+  if (!axis || !hasPlot(axis->parentPlot()))
+  {
+    qDebug() << Q_FUNC_INFO << "axis is zero or its parent plot isn't a member of this plot group:" << reinterpret_cast<quintptr>(axis);
+    return false;
+  }
+  if (mLinkedAxes.contains(axis))
+  {
+    qDebug() << Q_FUNC_INFO << "axis is already linked:" << reinterpret_cast<quintptr>(axis);
+    return false;
+  }
+  
+  const QList<QCPAxis*> others = linkedAxes();
+  if (!others.isEmpty())
+  {
+    mSyncingRanges = true;
+    axis->setRange(others.first()->range());
+    mSyncingRanges = false;
+    queueReplot(axis->parentPlot());
+  }
+  mLinkedAxes.append(axis);
+  connect(axis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(linkedRangeChanged(QCPRange)));
+  return true;
+}
+
+/*!
+  Stops synchronizing the range of \a axis with the other linked axes of this group.
+  
+  Returns false if \a axis isn't linked.
+  
+  \see linkAxis
+*/
+bool QCPPlotGroup::unlinkAxis(QCPAxis *axis)
+{
+  if (!axis || mLinkedAxes.removeAll(axis) == 0)
+  {
+    qDebug() << Q_FUNC_INFO << "axis isn't linked:" << reinterpret_cast<quintptr>(axis);
+    return false;
+  }
+  
+  disconnect(axis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(linkedRangeChanged(QCPRange)));
+  return true;
+}
+
+/*!
+  Creates a graph in \a plot that displays the data of the graph \a source, without copying it. Both
+  graphs share the same data container (see \ref QCPGraph::setData(QSharedPointer<QCPGraphDataContainer>)),
+  so data that is added to either graph appears in both after their plots were replotted. The new
+  graph takes over the name, pen, brush, line style and scatter style of \a source, and can be
+  styled independently afterwards.
+  
+  Note that changing the data only marks the layer of the graph it was changed through as dirty. So
+  if a plot of the group uses \ref QCP::phDirtyLayerReplot, the other graph isn't redrawn by a
+  partial replot. In that case, call \ref QCPLayer::markDirty on the layer of the other graph (or
+  \ref QCustomPlot::replot with a full replot) after changing the data.
+  
+  \a keyAxis and \a valueAxis are passed to \ref QCustomPlot::addGraph, so zero uses the default
+  axes of \a plot. \a plot must be a member of this group.
+  
+  Returns the new graph, or zero if the graph couldn't be created.
+*/
+QCPGraph *QCPPlotGroup::addSharedGraph(QCustomPlot *plot, const QCPGraph *source, QCPAxis *keyAxis, QCPAxis *valueAxis)
+{
+  if (!source || !hasPlot(plot))
+  {
+    qDebug() << Q_FUNC_INFO << "source graph is zero or plot isn't a member of this plot group";
+    return 0;
+  }
+  
+  QCPGraph *graph = plot->addGraph(keyAxis, valueAxis);
+  if (!graph)
+    return 0;
+  graph->setData(source->data());
+  graph->setName(source->name());
+  graph->setPen(source->pen());
+  graph->setBrush(source->brush());
+  graph->setLineStyle(source->lineStyle());
+  graph->setScatterStyle(source->scatterStyle());
+  queueReplot(plot);
+  return graph;
+}
+
+/*!
+  Queues a replot of the member plot \a plot for the next frame of the group. Several requests for
+  the same or for different plots before the frame tick result in one replot of each requested plot.
+  
+  This is what \ref QCustomPlot::replot does for member plots, when called with \ref
+  QCustomPlot::rpQueuedReplot.
+  
+  \see replot, setFrameInterval
+*/
+void QCPPlotGroup::queueReplot(QCustomPlot *plot)
+{
+  if (!hasPlot(plot))
+  {
+    qDebug() << Q_FUNC_INFO << "plot isn't a member of this plot group:" << reinterpret_cast<quintptr>(plot);
+    return;
+  }
+  
+  if (!mPendingPlots.contains(plot))
+    mPendingPlots.append(plot);
+  if (!mFrameTimer.isActive())
+    mFrameTimer.start(mFrameInterval);
+}
+
+/*!
+  Replots all member plots of this group.
+  
+  With the default \a refreshPriority \ref QCustomPlot::rpQueuedReplot, the replot of all plots is
+  queued for the next frame of the group (see \ref queueReplot). With any other priority, all plots
+  are replotted immediately with that priority, and pending queued replots are discarded.
+*/
+void QCPPlotGroup::replot(QCustomPlot::RefreshPriority refreshPriority)
+{
+  if (refreshPriority == QCustomPlot::rpQueuedReplot)
+  {
+    for (int i=0; i<mPlots.size(); ++i)
+    {
+      if (mPlots.at(i))
+        queueReplot(mPlots.at(i).data());
+    }
+    return;
+  }
+  
+  mFrameTimer.stop();
+  mPendingPlots.clear();
+  emit beforeReplot();
+  const QList<QCustomPlot*> members = plots();
+  for (int i=0; i<members.size(); ++i)
+    members.at(i)->replot(refreshPriority);
+  emit afterReplot();
+}
+
+/*! \internal
+  
+  Replots all plots whose replot was queued since the last frame. The plots only schedule their
+  widget repaint (\ref QCustomPlot::rpQueuedRefresh), so that all widgets are repainted together.
+*/
+void QCPPlotGroup::processQueuedReplots()
+{
+  if (mPendingPlots.isEmpty())
+    return;
+  
+  emit beforeReplot();
+  QList<QPointer<QCustomPlot> > plots;
+  plots.swap(mPendingPlots);
+  for (int i=0; i<plots.size(); ++i)
+  {
+    if (plots.at(i))
+      plots.at(i)->replot(QCustomPlot::rpQueuedRefresh);
+  }
+  emit afterReplot();
+  // replots may queue further plots (e.g. via signals), those wait for the next frame, so a feedback loop can't stall the event loop:
+  if (!mPendingPlots.isEmpty() && !mFrameTimer.isActive())
+    mFrameTimer.start(mFrameInterval);
+}
+
+/*! \internal
+  
+  Called when the range of one of the linked axes changes. Applies \a newRange to all other linked
+  axes and queues the replot of their plots. Range changes caused by this method itself are
+  ignored, so every change is forwarded exactly once.
+*/
+void QCPPlotGroup::linkedRangeChanged(const QCPRange &newRange)
+{
+  if (mSyncingRanges)
+    return;
+  QCPAxis *source = qobject_cast<QCPAxis*>(sender());
+  if (!source)
+    return;
+  
+  mSyncingRanges = true;
+  for (int i=0; i<mLinkedAxes.size(); ++i)
+  {
+    QCPAxis *axis = mLinkedAxes.at(i).data();
+    if (axis && axis != source)
+    {
+      axis->setRange(newRange);
+      queueReplot(axis->parentPlot());
+    }
+  }
+  mSyncingRanges = false;
+}
+/* end of 'src/core.cpp' */
+
+//amalgamation: add plottable1d.cpp
+
+/* including file 'src/colorgradient.cpp', size 25342                        */
+/* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPColorGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPColorGradient
+  \brief Defines a color gradient for use with e.g. \ref QCPColorMap
+  
+  This class describes a color gradient which can be used to encode data with color. For example,
+  QCPColorMap and QCPColorScale have \ref QCPColorMap::setGradient "setGradient" methods which
+  take an instance of this class. Colors are set with \ref setColorStopAt(double position, const QColor &color)
+  with a \a position from 0 to 1. In between these defined color positions, the
+  color will be interpolated linearly either in RGB or HSV space, see \ref setColorInterpolation.
+
+  Alternatively, load one of the preset color gradients shown in the image below, with \ref
+  loadPreset, or by directly specifying the preset in the constructor.
+  
+  Apart from red, green and blue components, the gradient also interpolates the alpha values of the
+  configured color stops. This allows to display some portions of the data range as transparent in
+  the plot.
+  
+  \image html QCPColorGradient.png
+  
+  The \ref QCPColorGradient(GradientPreset preset) constructor allows directly converting a \ref
+  GradientPreset to a QCPColorGradient. This means that you can directly pass \ref GradientPreset
+  to all the \a setGradient methods, e.g.:
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpcolorgradient-setgradient
+  
+  The total number of levels used in the gradient can be set with \ref setLevelCount. Whether the
+  color gradient shall be applied periodically (wrapping around) to data values that lie outside
+  the data range specified on the plottable instance can be controlled with \ref setPeriodic.
+*/
+
+/*!
+  Constructs a new, empty QCPColorGradient with no predefined color stops. You can add own color
+  stops with \ref setColorStopAt.
+
+  The color level count is initialized to 350.
+*/
+QCPColorGradient::QCPColorGradient() :
+  mLevelCount(350),
+  mColorInterpolation(ciRGB),
+  mPeriodic(false),
+  mColorBufferInvalidated(true)
+{
+  mColorBuffer.fill(qRgb(0, 0, 0), mLevelCount);
+}
+
+/*!
+  Constructs a new QCPColorGradient initialized with the colors and color interpolation according
+  to \a preset.
+
+  The color level count is initialized to 350.
+*/
+QCPColorGradient::QCPColorGradient(GradientPreset preset) :
+  mLevelCount(350),
+  mColorInterpolation(ciRGB),
+  mPeriodic(false),
+  mColorBufferInvalidated(true)
+{
+  mColorBuffer.fill(qRgb(0, 0, 0), mLevelCount);
+  loadPreset(preset);
+}
+
+/* undocumented operator */
+bool QCPColorGradient::operator==(const QCPColorGradient &other) const
+{
+  return ((other.mLevelCount == this->mLevelCount) &&
+          (other.mColorInterpolation == this->mColorInterpolation) &&
+          (other.mPeriodic == this->mPeriodic) &&
+          (other.mColorStops == this->mColorStops));
+}
+
+/*!
+  Sets the number of discretization levels of the color gradient to \a n. The default is 350 which
+  is typically enough to create a smooth appearance. The minimum number of levels is 2.
+
+  \image html QCPColorGradient-levelcount.png
+*/
+void QCPColorGradient::setLevelCount(int n)
+{
+  if (n < 2)
+  {
+    qDebug() << Q_FUNC_INFO << "n must be greater or equal 2 but was" << n;
+    n = 2;
+  }
+  if (n != mLevelCount)
+  {
+    mLevelCount = n;
+    mColorBufferInvalidated = true;
+  }
+}
+
+/*!
+  Sets at which positions from 0 to 1 which color shall occur. The positions are the keys, the
+  colors are the values of the passed QMap \a colorStops. In between these color stops, the color
+  is interpolated according to \ref setColorInterpolation.
+  
+  A more convenient way to create a custom gradient may be to clear all color stops with \ref
+  clearColorStops (or creating a new, empty QCPColorGradient) and then adding them one by one with
+  \ref setColorStopAt.
+  
+  \see clearColorStops
+*/
+void QCPColorGradient::setColorStops(const QMap<double, QColor> &colorStops)
+{
+  mColorStops = colorStops;
+  mColorBufferInvalidated = true;
+}
+
+/*!
+  Sets the \a color the gradient will have at the specified \a position (from 0 to 1). In between
+  these color stops, the color is interpolated according to \ref setColorInterpolation.
+  
+  \see setColorStops, clearColorStops
+*/
+void QCPColorGradient::setColorStopAt(double position, const QColor &color)
+{
+  mColorStops.insert(position, color);
+  mColorBufferInvalidated = true;
+}
+
+/*!
+  Sets whether the colors in between the configured color stops (see \ref setColorStopAt) shall be
+  interpolated linearly in RGB or in HSV color space.
   
   For example, a sweep in RGB space from red to green will have a muddy brown intermediate color,
   whereas in HSV space the intermediate color is yellow.
@@ -15940,6 +17757,10 @@ void QCPColorGradient::colorize(const double *data, const QCPRange &range, QRgb
   if (mColorBufferInvalidated)
     updateColorBuffer();
   
+  // the index transforms are hoisted out of the loops, and non-periodic indices are clamped as doubles, which
+  // compiles to branch-free min/max and also keeps out-of-range values from overflowing the int conversion:
+  const QRgb *colorBuffer = mColorBuffer.constData();
+  const double maxIndex = mLevelCount-1;
   if (!logarithmic)
   {
     const double posToIndexFactor = (mLevelCount-1)/range.size();
@@ -15950,42 +17771,29 @@ void QCPColorGradient::colorize(const double *data, const QCPRange &range, QRgb
         int index = (int)((data[dataIndexFactor*i]-range.lower)*posToIndexFactor) % mLevelCount;
         if (index < 0)
           index += mLevelCount;
-        scanLine[i] = mColorBuffer.at(index);
+        scanLine[i] = colorBuffer[index];
       }
     } else
     {
       for (int i=0; i<n; ++i)
-      {
-        int index = (data[dataIndexFactor*i]-range.lower)*posToIndexFactor;
-        if (index < 0)
-          index = 0;
-        else if (index >= mLevelCount)
-          index = mLevelCount-1;
-        scanLine[i] = mColorBuffer.at(index);
-      }
+        scanLine[i] = colorBuffer[(int)qMin(maxIndex, qMax(0.0, (data[dataIndexFactor*i]-range.lower)*posToIndexFactor))];
     }
   } else // logarithmic == true
   {
+    const double logPosToIndexFactor = (mLevelCount-1)/qLn(range.upper/range.lower);
     if (mPeriodic)
     {
       for (int i=0; i<n; ++i)
       {
-        int index = (int)(qLn(data[dataIndexFactor*i]/range.lower)/qLn(range.upper/range.lower)*(mLevelCount-1)) % mLevelCount;
+        int index = (int)(qLn(data[dataIndexFactor*i]/range.lower)*logPosToIndexFactor) % mLevelCount;
         if (index < 0)
           index += mLevelCount;
-        scanLine[i] = mColorBuffer.at(index);
+        scanLine[i] = colorBuffer[index];
       }
     } else
     {
       for (int i=0; i<n; ++i)
-      {
-        int index = qLn(data[dataIndexFactor*i]/range.lower)/qLn(range.upper/range.lower)*(mLevelCount-1);
-        if (index < 0)
-          index = 0;
-        else if (index >= mLevelCount)
-          index = mLevelCount-1;
-        scanLine[i] = mColorBuffer.at(index);
-      }
+        scanLine[i] = colorBuffer[(int)qMin(maxIndex, qMax(0.0, qLn(data[dataIndexFactor*i]/range.lower)*logPosToIndexFactor))];
     }
   }
 }
@@ -16019,6 +17827,8 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
   if (mColorBufferInvalidated)
     updateColorBuffer();
   
+  const QRgb *colorBuffer = mColorBuffer.constData();
+  const double maxIndex = mLevelCount-1;
   if (!logarithmic)
   {
     const double posToIndexFactor = (mLevelCount-1)/range.size();
@@ -16031,10 +17841,10 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
           index += mLevelCount;
         if (alpha[dataIndexFactor*i] == 255)
         {
-          scanLine[i] = mColorBuffer.at(index);
+          scanLine[i] = colorBuffer[index];
         } else
         {
-          const QRgb rgb = mColorBuffer.at(index);
+          const QRgb rgb = colorBuffer[index];
           const float alphaF = alpha[dataIndexFactor*i]/255.0f;
           scanLine[i] = qRgba(qRed(rgb)*alphaF, qGreen(rgb)*alphaF, qBlue(rgb)*alphaF, qAlpha(rgb)*alphaF);
         }
@@ -16043,17 +17853,13 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
     {
       for (int i=0; i<n; ++i)
       {
-        int index = (data[dataIndexFactor*i]-range.lower)*posToIndexFactor;
-        if (index < 0)
-          index = 0;
-        else if (index >= mLevelCount)
-          index = mLevelCount-1;
+        const int index = qMin(maxIndex, qMax(0.0, (data[dataIndexFactor*i]-range.lower)*posToIndexFactor));
         if (alpha[dataIndexFactor*i] == 255)
         {
-          scanLine[i] = mColorBuffer.at(index);
+          scanLine[i] = colorBuffer[index];
         } else
         {
-          const QRgb rgb = mColorBuffer.at(index);
+          const QRgb rgb = colorBuffer[index];
           const float alphaF = alpha[dataIndexFactor*i]/255.0f;
           scanLine[i] = qRgba(qRed(rgb)*alphaF, qGreen(rgb)*alphaF, qBlue(rgb)*alphaF, qAlpha(rgb)*alphaF);
         }
@@ -16061,19 +17867,20 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
     }
   } else // logarithmic == true
   {
+    const double logPosToIndexFactor = (mLevelCount-1)/qLn(range.upper/range.lower);
     if (mPeriodic)
     {
       for (int i=0; i<n; ++i)
       {
-        int index = (int)(qLn(data[dataIndexFactor*i]/range.lower)/qLn(range.upper/range.lower)*(mLevelCount-1)) % mLevelCount;
+        int index = (int)(qLn(data[dataIndexFactor*i]/range.lower)*logPosToIndexFactor) % mLevelCount;
         if (index < 0)
           index += mLevelCount;
         if (alpha[dataIndexFactor*i] == 255)
         {
-          scanLine[i] = mColorBuffer.at(index);
+          scanLine[i] = colorBuffer[index];
         } else
         {
-          const QRgb rgb = mColorBuffer.at(index);
+          const QRgb rgb = colorBuffer[index];
           const float alphaF = alpha[dataIndexFactor*i]/255.0f;
           scanLine[i] = qRgba(qRed(rgb)*alphaF, qGreen(rgb)*alphaF, qBlue(rgb)*alphaF, qAlpha(rgb)*alphaF);
         }
@@ -16082,17 +17889,13 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
     {
       for (int i=0; i<n; ++i)
       {
-        int index = qLn(data[dataIndexFactor*i]/range.lower)/qLn(range.upper/range.lower)*(mLevelCount-1);
-        if (index < 0)
-          index = 0;
-        else if (index >= mLevelCount)
-          index = mLevelCount-1;
+        const int index = qMin(maxIndex, qMax(0.0, qLn(data[dataIndexFactor*i]/range.lower)*logPosToIndexFactor));
         if (alpha[dataIndexFactor*i] == 255)
         {
-          scanLine[i] = mColorBuffer.at(index);
+          scanLine[i] = colorBuffer[index];
         } else
         {
-          const QRgb rgb = mColorBuffer.at(index);
+          const QRgb rgb = colorBuffer[index];
           const float alphaF = alpha[dataIndexFactor*i]/255.0f;
           scanLine[i] = qRgba(qRed(rgb)*alphaF, qGreen(rgb)*alphaF, qBlue(rgb)*alphaF, qAlpha(rgb)*alphaF);
         }
@@ -16826,6 +18629,7 @@ QCPAxisRect::QCPAxisRect(QCustomPlot *parentPlot, bool setupDefaultAxes) :
   mRangeZoom(Qt::Horizontal|Qt::Vertical),
   mRangeZoomFactorHorz(0.85),
   mRangeZoomFactorVert(0.85),
+  mStripChart(false),
   mDragging(false)
 {
   mInsetLayout->initializeParentPlot(mParentPlot);
@@ -17682,6 +19486,33 @@ void QCPAxisRect::setRangeZoomFactor(double factor)
   mRangeZoomFactorVert = factor;
 }
 
+/*!
+  Sets whether this axis rect is rendered as a scrolling strip chart.
+
+  In a live plot with a fixed key window, each new sample typically scrolls the horizontal axes by a
+  small amount without changing their range size. In strip chart mode, \ref QCustomPlot::replot
+  then moves the previous raster of the plottables by the scrolled distance and only redraws the
+  newly exposed strip at the leading edge (plus a small margin for line joins and scatter symbols
+  reaching across it). This makes the cost of such a replot proportional to the newly appended data
+  instead of the visible data. Grid, axes and other layers depending on the scrolled axes are still
+  redrawn completely.
+
+  The raster can only be reused for plottables on a layer in \ref QCPLayer::lmBuffered mode, which
+  holds nothing but plottables whose key axis is a horizontal axis of this axis rect, and only with
+  paint buffers that support scrolling (the default pixmap buffer, not OpenGL). A complete redraw
+  is done whenever the range size or scale of any axis, the value ranges, or the layout change, or
+  when the rounding of the scroll distance to whole device pixels has accumulated to half a pixel.
+
+  Strip chart mode builds on the partial replot of dirty layers, so the plotting hint \ref
+  QCP::phDirtyLayerReplot must be set for it to take effect. By default it is disabled.
+
+  \see QCustomPlot::setPlottingHint
+*/
+void QCPAxisRect::setStripChart(bool enabled)
+{
+  mStripChart = enabled;
+}
+
 /*! \internal
   
   Draws the background of this axis rect. It may consist of a background fill (a QBrush) and a
@@ -20106,7 +21937,16 @@ QCPGraphData::QCPGraphData(double key, double value) :
   To directly create a graph inside a plot, you can also use the simpler QCustomPlot::addGraph function.
 */
 QCPGraph::QCPGraph(QCPAxis *keyAxis, QCPAxis *valueAxis) :
-  QCPAbstractPlottable1D<QCPGraphData>(keyAxis, valueAxis)
+  QCPAbstractPlottable1D<QCPGraphData>(keyAxis, valueAxis),
+  mLodPyramid(false),
+  mBatchedLines(false),
+  mBackgroundPreparation(false),
+  mPreparationHandoff(new PreparationHandoff),
+  mLodSource(0),
+  mLodPointCount(0),
+  mLodEvictedCount(0),
+  mLodFirstKey(0),
+  mLodLastKey(0)
 {
   // special handling for QCPGraphs to maintain the simple graph interface:
   mParentPlot->registerGraph(this);
@@ -20122,6 +21962,8 @@ QCPGraph::QCPGraph(QCPAxis *keyAxis, QCPAxis *valueAxis) :
 
 QCPGraph::~QCPGraph()
 {
+  QMutexLocker locker(&mPreparationHandoff->mutex);
+  mPreparationHandoff->graph = 0;
 }
 
 /*! \overload
@@ -20142,6 +21984,8 @@ QCPGraph::~QCPGraph()
 void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
 {
   mDataContainer = data;
+  invalidateLodPyramid();
+  markLayerDirty();
 }
 
 /*! \overload
@@ -20157,15 +22001,50 @@ void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
 */
 void QCPGraph::setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
 {
-  mDataContainer->clear();
-  addData(keys, values, alreadySorted);
+  if (keys.size() != values.size())
+    qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
+  setData(keys.constData(), values.constData(), qMin(keys.size(), values.size()), alreadySorted);
 }
 
-/*!
-  Sets how the single data points are connected in the plot. For scatter-only plots, set \a ls to
-  \ref lsNone and \ref setScatterStyle to the desired scatter style.
+/*! \overload
   
-  \see setScatterStyle
+  Replaces the current data with \a count points, whose keys and values are read from the separate
+  arrays \a keys and \a values. This allows importing columnar data (e.g. the key and value columns
+  of a log or a column store) without first copying them into QVectors.
+  
+  The columns are interleaved into a new buffer in a single pass, which is then sorted if necessary
+  and adopted by the container. Unless the container has a rolling capacity that the data exceeds
+  (\ref QCPDataContainer::setRollingCapacity), this doesn't copy the buffer again. The arrays may be
+  released or reused once this method returns.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  
+  \see addData
+*/
+void QCPGraph::setData(const double *keys, const double *values, int count, bool alreadySorted)
+{
+  QVector<QCPGraphData> tempData(qMax(0, count));
+  QVector<QCPGraphData>::iterator it = tempData.begin();
+  for (int i=0; i<tempData.size(); ++i, ++it)
+  {
+    it->key = keys[i];
+    it->value = values[i];
+  }
+  if (!alreadySorted) // sort before handing over, sorting the shared buffer in the container would detach it
+    std::sort(tempData.begin(), tempData.end(), qcpLessThanSortKey<QCPGraphData>);
+  mDataContainer->set(tempData, true); // container shares tempData, don't modify it beyond this to prevent copy on write
+  invalidateLodPyramid();
+  if (mLodPyramid)
+    updateLodPyramid();
+  markLayerDirty();
+}
+
+/*!
+  Sets how the single data points are connected in the plot. For scatter-only plots, set \a ls to
+  \ref lsNone and \ref setScatterStyle to the desired scatter style.
+  
+  \see setScatterStyle
 */
 void QCPGraph::setLineStyle(LineStyle ls)
 {
@@ -20264,6 +22143,94 @@ void QCPGraph::setAdaptiveSampling(bool enabled)
   mAdaptiveSampling = enabled;
 }
 
+/*!
+  Sets whether this graph maintains a min/max level-of-detail pyramid of its data, to speed up
+  adaptive sampling of line plots with a very large number of points.
+
+  The pyramid summarizes blocks of consecutive data points by their first, last, minimum and maximum
+  value. Each level merges two blocks of the level below. When adaptive sampling reduces the
+  visible data (see \ref setAdaptiveSampling), the graph picks the coarsest level whose blocks are
+  still smaller than one pixel and draws four points per block, instead of walking every data
+  point in the visible key range. The replot cost of a long history is then bounded by the width
+  of the axis rect rather than by the number of points. Since only real data points are emitted,
+  the outliers and the envelope of the line look the same as with the regular adaptive sampling.
+
+  The pyramid is extended incrementally by \ref addData, so appending points stays cheap. Removing
+  points from the front, e.g. by a rolling capacity (\ref QCPDataContainer::setRollingCapacity) or
+  \ref QCPDataContainer::removeBefore, is handled incrementally too, by dropping the blocks that
+  contain removed points. This requires the last summarized key to be unique in the data. If the
+  data is changed in a way that can't be detected from the keys at the ends of the summarized
+  range (e.g. by modifying values in place through \ref data), call \ref invalidateLodPyramid.
+  Other removals, and prepending data, are detected and cause a rebuild on the next replot.
+
+  The pyramid is only used for line plots on a linear key axis. It costs roughly an eighth of the
+  memory of the data itself. By default, it is disabled.
+*/
+void QCPGraph::setLodPyramid(bool enabled)
+{
+  if (mLodPyramid == enabled)
+    return;
+  
+  mLodPyramid = enabled;
+  invalidateLodPyramid();
+  if (mLodPyramid)
+    updateLodPyramid();
+}
+
+/*!
+  Sets whether the line of this graph is drawn in clipped batches, instead of passing the whole line
+  to a single polyline call.
+  
+  With batched lines enabled, every line segment is first clipped to the axis rect. The remaining
+  visible runs are drawn as polylines of at most a few hundred points each. So the parts of the
+  line outside the axis rect are never stroked, and no single polyline call gets arbitrarily long.
+  Whether this is faster than a single polyline depends on the paint engine, the pen width,
+  antialiasing and the shape of the data, so measure it for your use case before enabling it.
+  Whether the line is antialiased is still controlled per graph with \ref setAntialiased.
+  
+  Unlike \ref QCP::phFastPolylines, the batches keep the line joins within each batch. At the
+  boundaries of batches and where the line leaves the axis rect, the join is omitted, which is only
+  visible for very wide pens. Lines with a pen style other than Qt::SolidLine are always drawn as a
+  single polyline, so dash patterns stay continuous.
+  
+  By default, batched lines are disabled.
+*/
+void QCPGraph::setBatchedLines(bool enabled)
+{
+  mBatchedLines = enabled;
+}
+
+/*!
+  Sets whether the pixel coordinates of the line and scatter points of this graph are prepared on a
+  worker thread, instead of during the replot on the GUI thread.
+  
+  For graphs with very many data points, sampling the visible data and transforming it to pixels
+  dominates the replot time, and blocks the handling of user input. With background preparation
+  enabled, the graph takes a snapshot of its visible data and axes whenever either changed since the
+  last preparation, and prepares the pixel buffers from it on the global QThreadPool. The snapshot
+  is a plain copy of the data points in the visible key range, made once per preparation. This is
+  much cheaper than the sampling and pixel transformation it moves off the GUI thread, and the
+  data container stays unshared, so appending data never causes a detach.
+  
+  The replot never waits for the preparation. Until the new buffers are ready, the graph draws the
+  previously prepared buffers, transformed to the current axis ranges. Data that became visible or
+  was added in the meantime appears with the next replot, which the graph requests as soon as the
+  preparation is finished. Only when no buffers were prepared yet, the graph is drawn synchronously.
+  
+  The background preparation applies to the line styles \ref lsLine and \ref lsNone. On the key
+  axis, adaptive sampling (\ref setAdaptiveSampling) keeps the first, minimum, maximum and last data
+  point per pixel. Graphs with other line styles or with selected data, and vector exports, are
+  drawn with the regular synchronous preparation.
+  
+  By default, background preparation is disabled.
+*/
+void QCPGraph::setBackgroundPreparation(bool enabled)
+{
+  mBackgroundPreparation = enabled;
+  if (!mBackgroundPreparation)
+    mPreparedBuffers = PreparedBuffers();
+}
+
 /*! \overload
   
   Adds the provided points in \a keys and \a values to the current data. The provided vectors
@@ -20280,19 +22247,33 @@ void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &value
 {
   if (keys.size() != values.size())
     qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
-  const int n = qMin(keys.size(), values.size());
-  QVector<QCPGraphData> tempData(n);
+  addData(keys.constData(), values.constData(), qMin(keys.size(), values.size()), alreadySorted);
+}
+
+/*! \overload
+  
+  Adds \a count points to the current data, whose keys and values are read from the separate arrays
+  \a keys and \a values. Like \ref setData(const double *keys, const double *values, int count, bool alreadySorted),
+  this imports columnar data without copying it into QVectors first.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+*/
+void QCPGraph::addData(const double *keys, const double *values, int count, bool alreadySorted)
+{
+  if (count <= 0)
+    return;
+  QVector<QCPGraphData> tempData(count);
   QVector<QCPGraphData>::iterator it = tempData.begin();
-  const QVector<QCPGraphData>::iterator itEnd = tempData.end();
-  int i = 0;
-  while (it != itEnd)
+  for (int i=0; i<count; ++i, ++it)
   {
     it->key = keys[i];
     it->value = values[i];
-    ++it;
-    ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  if (mLodPyramid)
+    updateLodPyramid();
+  markLayerDirty();
 }
 
 /*! \overload
@@ -20305,6 +22286,25 @@ void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &value
 void QCPGraph::addData(double key, double value)
 {
   mDataContainer->add(QCPGraphData(key, value));
+  if (mLodPyramid)
+    updateLodPyramid();
+  markLayerDirty();
+}
+
+/*!
+  Discards the level-of-detail pyramid, so it is rebuilt from the data on the next replot. This
+  is only necessary if the values of the data were modified directly via \ref data while the
+  pyramid is enabled.
+
+  \see setLodPyramid
+*/
+void QCPGraph::invalidateLodPyramid()
+{
+  mLodLevels.clear();
+  mLodLevelOffsets.clear();
+  mLodSource = 0;
+  mLodPointCount = 0;
+  mLodEvictedCount = 0;
 }
 
 /*!
@@ -20355,7 +22355,27 @@ void QCPGraph::draw(QCPPainter *painter)
   if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
   if (mLineStyle == lsNone && mScatterStyle.isNone()) return;
   
+  // if only a strip of the axis rect is redrawn (see QCPAxisRect::setStripChart), skip the data outside of it:
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPDataRange clipDataRange = mDataContainer->dataRange();
+  if (painter->hasClipping())
+  {
+    const QRectF clip = painter->clipBoundingRect();
+    const bool keyHorizontal = keyAxis->orientation() == Qt::Horizontal;
+    if ((keyHorizontal ? clip.width() : clip.height()) < (keyHorizontal ? keyAxis->axisRect()->width() : keyAxis->axisRect()->height())-1)
+    {
+      QCPRange clipKeyRange(keyAxis->pixelToCoord(keyHorizontal ? clip.left() : clip.bottom()), keyAxis->pixelToCoord(keyHorizontal ? clip.right() : clip.top()));
+      clipKeyRange.normalize();
+      clipDataRange = QCPDataRange(findBegin(clipKeyRange.lower), findEnd(clipKeyRange.upper));
+    }
+  }
+  
+  if (mBackgroundPreparation && drawPreparedBuffers(painter, clipDataRange))
+    return;
+  
   QVector<QPointF> lines, scatters; // line and (if necessary) scatter pixel coordinates will be stored here while iterating over segments
+  // vector exports may decimate the line for the resolution of the target device instead of the screen:
+  const double exportDotsPerPixel = painter->modes().testFlag(QCPPainter::pmVectorized) ? mParentPlot->exportResolution()/72.0 : 0;
   
   // loop over and draw segments of unselected/selected data:
   QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
@@ -20366,7 +22386,10 @@ void QCPGraph::draw(QCPPainter *painter)
     bool isSelectedSegment = i >= unselectedSegments.size();
     // get line pixel points appropriate to line style:
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getLines takes care)
-    getLines(&lines, lineDataRange);
+    if (exportDotsPerPixel > 0)
+      getExportLines(&lines, lineDataRange.bounded(clipDataRange), exportDotsPerPixel);
+    else
+      getLines(&lines, lineDataRange.bounded(clipDataRange));
     
     // check data validity if flag set:
 #ifdef QCUSTOMPLOT_CHECK_DATA
@@ -20406,7 +22429,7 @@ void QCPGraph::draw(QCPPainter *painter)
       finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
     if (!finalScatterStyle.isNone())
     {
-      getScatters(&scatters, allSegments.at(i));
+      getScatters(&scatters, allSegments.at(i).bounded(clipDataRange));
       drawScatterPlot(painter, scatters, finalScatterStyle);
     }
   }
@@ -20500,6 +22523,273 @@ void QCPGraph::getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange)
   }
 }
 
+/*! \internal
+  
+  Like \ref getLines, but instead of adaptive sampling for the screen, the line is decimated for an
+  output device with \a dotsPerPixel device dots per plot pixel. This is used when exporting to a
+  vector format, see \ref QCustomPlot::setExportResolution.
+  
+  For \ref lsLine, the data is first reduced with \ref getMinMaxDecimatedData. Step styles would be
+  distorted by collapsing data points, so their pixel polyline is reduced with \ref
+  decimatePolyline instead. For all line styles except \ref lsImpulse, the resulting polyline,
+  which then has at most four vertices per device dot, is simplified with \ref simplifyPolyline,
+  with a tolerance of half a device dot.
+*/
+void QCPGraph::getExportLines(QVector<QPointF> *lines, const QCPDataRange &dataRange, double dotsPerPixel) const
+{
+  if (!lines) return;
+  if (mLineStyle == lsNone || mLineStyle == lsImpulse) // impulses are separate lines, not a polyline that could be simplified
+  {
+    getLines(lines, dataRange);
+    return;
+  }
+  QCPGraphDataContainer::const_iterator begin, end;
+  getVisibleDataBounds(begin, end, dataRange);
+  if (begin == end)
+  {
+    lines->clear();
+    return;
+  }
+  
+  QVector<QCPGraphData> lineData;
+  if (mLineStyle == lsLine)
+    getMinMaxDecimatedData(&lineData, begin, end, dotsPerPixel);
+  else // step styles would be distorted by collapsing points, they are decimated after conversion to pixels
+  {
+    lineData.resize(end-begin);
+    std::copy(begin, end, lineData.begin());
+  }
+  
+  if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in lineData (significantly simplifies following processing)
+    std::reverse(lineData.begin(), lineData.end());
+  
+  switch (mLineStyle)
+  {
+    case lsLine: *lines = dataToLines(lineData); break;
+    case lsStepLeft: *lines = dataToStepLeftLines(lineData); break;
+    case lsStepRight: *lines = dataToStepRightLines(lineData); break;
+    case lsStepCenter: *lines = dataToStepCenterLines(lineData); break;
+    default: break;
+  }
+  if (mLineStyle != lsLine)
+    *lines = decimatePolyline(*lines, mKeyAxis->orientation(), dotsPerPixel);
+  *lines = simplifyPolyline(*lines, 0.5/dotsPerPixel);
+}
+
+/*! \internal
+  
+  Reduces the data between \a begin and \a end to at most four points per device dot along the key
+  axis, where a plot pixel spans \a dotsPerPixel device dots. For each dot, the first, the minimum,
+  the maximum and the last data point in it are kept, in their original order. Unlike the adaptive
+  sampling of \ref getOptimizedLineData, only real data points are emitted, so the envelope of the
+  line is preserved exactly. Data points with NaN values are kept, to preserve the gaps in the line.
+  
+  \see appendDecimationBin
+*/
+void QCPGraph::getMinMaxDecimatedData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end, double dotsPerPixel) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  if (!keyAxis) { qDebug() << Q_FUNC_INFO << "invalid key axis"; return; }
+  
+  QCPGraphDataContainer::const_iterator first = begin, minIt = begin, maxIt = begin, last = begin;
+  double binIndex = 0;
+  bool binOpen = false;
+  for (QCPGraphDataContainer::const_iterator it = begin; it != end; ++it)
+  {
+    if (qIsNaN(it->value))
+    {
+      if (binOpen)
+        appendDecimationBin(lineData, first, minIt, maxIt, last);
+      binOpen = false;
+      lineData->append(*it);
+      continue;
+    }
+    const double index = floor(keyAxis->coordToPixel(it->key)*dotsPerPixel); // do not use qFloor here, it returns an int
+    if (binOpen && index == binIndex)
+    {
+      if (it->value < minIt->value)
+        minIt = it;
+      if (it->value > maxIt->value)
+        maxIt = it;
+      last = it;
+    } else
+    {
+      if (binOpen)
+        appendDecimationBin(lineData, first, minIt, maxIt, last);
+      first = minIt = maxIt = last = it;
+      binIndex = index;
+      binOpen = true;
+    }
+  }
+  if (binOpen)
+    appendDecimationBin(lineData, first, minIt, maxIt, last);
+}
+
+/*! \internal
+  
+  Appends the data points \a first, \a minIt, \a maxIt and \a last of one decimation bin to \a
+  lineData, ordered by their position in the data container and without duplicates.
+  
+  \see getMinMaxDecimatedData
+*/
+void QCPGraph::appendDecimationBin(QVector<QCPGraphData> *lineData, QCPGraphDataContainer::const_iterator first, QCPGraphDataContainer::const_iterator minIt, QCPGraphDataContainer::const_iterator maxIt, QCPGraphDataContainer::const_iterator last)
+{
+  if (maxIt < minIt)
+    qSwap(minIt, maxIt);
+  lineData->append(*first);
+  if (minIt != first)
+    lineData->append(*minIt);
+  if (maxIt != minIt)
+    lineData->append(*maxIt);
+  if (last != maxIt)
+    lineData->append(*last);
+}
+
+/*! \internal
+  
+  Reduces the polyline \a points, whose vertices are ordered along the key axis with orientation \a
+  keyOrientation, to at most four vertices per device dot, where a pixel spans \a dotsPerPixel
+  device dots. Like \ref getMinMaxDecimatedData does for data points, the first, the minimum, the
+  maximum and the last vertex of each dot are kept in their original order, so the envelope of the
+  line is preserved. Vertices with NaN coordinates are kept, to preserve the gaps in the line.
+  
+  This bounds the input of \ref simplifyPolyline for step lines, whose vertices can't be decimated
+  as data points.
+*/
+QVector<QPointF> QCPGraph::decimatePolyline(const QVector<QPointF> &points, Qt::Orientation keyOrientation, double dotsPerPixel)
+{
+  QVector<QPointF> result;
+  result.reserve(qMin(points.size(), 1024));
+  const bool horizontal = keyOrientation == Qt::Horizontal;
+  int first = 0, minIndex = 0, maxIndex = 0, last = 0;
+  double minCross = 0, maxCross = 0, binIndex = 0;
+  bool binOpen = false;
+  for (int i=0; i<=points.size(); ++i)
+  {
+    const bool atEnd = i == points.size();
+    const bool isNan = !atEnd && (qIsNaN(points.at(i).x()) || qIsNaN(points.at(i).y()));
+    const double key = atEnd || isNan ? 0 : (horizontal ? points.at(i).x() : points.at(i).y());
+    const double cross = atEnd || isNan ? 0 : (horizontal ? points.at(i).y() : points.at(i).x());
+    const double index = floor(key*dotsPerPixel); // do not use qFloor here, it returns an int
+    if (binOpen && !atEnd && !isNan && index == binIndex)
+    {
+      if (cross < minCross)
+      {
+        minCross = cross;
+        minIndex = i;
+      }
+      if (cross > maxCross)
+      {
+        maxCross = cross;
+        maxIndex = i;
+      }
+      last = i;
+      continue;
+    }
+    if (binOpen) // close the current bin, emitting its vertices in their original order
+    {
+      result.append(points.at(first));
+      const int lower = qMin(minIndex, maxIndex), upper = qMax(minIndex, maxIndex);
+      if (lower != first)
+        result.append(points.at(lower));
+      if (upper != lower && upper != first)
+        result.append(points.at(upper));
+      if (last != upper && last != first)
+        result.append(points.at(last));
+      binOpen = false;
+    }
+    if (atEnd)
+      break;
+    if (isNan)
+    {
+      result.append(points.at(i));
+      continue;
+    }
+    first = minIndex = maxIndex = last = i;
+    minCross = maxCross = cross;
+    binIndex = index;
+    binOpen = true;
+  }
+  return result;
+}
+
+/*! \internal
+  
+  Simplifies the polyline \a points with the Douglas-Peucker algorithm, such that no removed point
+  is further than \a tolerance (in pixels) away from the simplified line. Points with NaN or
+  infinite coordinates are kept, and divide the polyline into runs that are simplified
+  independently, so gaps in the line are preserved.
+  
+  The recursion of the algorithm is done with an explicit stack, so very long runs can't overflow
+  the call stack.
+*/
+QVector<QPointF> QCPGraph::simplifyPolyline(const QVector<QPointF> &points, double tolerance)
+{
+  const int pointCount = points.size();
+  if (pointCount < 3)
+    return points;
+  
+  const double toleranceSqr = tolerance*tolerance;
+  QVector<bool> keep(pointCount, false);
+  QVector<QPair<int, int> > spans; // pending index spans [first, last] whose inner points aren't decided yet
+  int runStart = -1;
+  for (int i=0; i<=pointCount; ++i)
+  {
+    const bool valid = i < pointCount && !qIsNaN(points.at(i).x()) && !qIsNaN(points.at(i).y()) && !qIsInf(points.at(i).x()) && !qIsInf(points.at(i).y());
+    if (valid)
+    {
+      if (runStart < 0)
+        runStart = i;
+      continue;
+    }
+    if (i < pointCount)
+      keep[i] = true;
+    if (runStart < 0)
+      continue;
+    
+    // simplify the run of valid points that just ended:
+    keep[runStart] = true;
+    keep[i-1] = true;
+    if (i-1-runStart >= 2)
+      spans.append(qMakePair(runStart, i-1));
+    while (!spans.isEmpty())
+    {
+      const QPair<int, int> span = spans.takeLast();
+      const QCPVector2D spanStart(points.at(span.first));
+      const QCPVector2D spanEnd(points.at(span.second));
+      double maxDistSqr = -1;
+      int maxIndex = -1;
+      for (int k=span.first+1; k<span.second; ++k)
+      {
+        const double distSqr = QCPVector2D(points.at(k)).distanceSquaredToLine(spanStart, spanEnd);
+        if (distSqr > maxDistSqr)
+        {
+          maxDistSqr = distSqr;
+          maxIndex = k;
+        }
+      }
+      if (maxDistSqr > toleranceSqr)
+      {
+        keep[maxIndex] = true;
+        if (maxIndex-span.first >= 2)
+          spans.append(qMakePair(span.first, maxIndex));
+        if (span.second-maxIndex >= 2)
+          spans.append(qMakePair(maxIndex, span.second));
+      }
+    }
+    runStart = -1;
+  }
+  
+  QVector<QPointF> result;
+  result.reserve(pointCount);
+  for (int i=0; i<pointCount; ++i)
+  {
+    if (keep.at(i))
+      result.append(points.at(i));
+  }
+  return result;
+}
+
 /*! \internal
 
   This method retrieves an optimized set of data points via \ref getOptimizedScatterData and then
@@ -20533,28 +22823,10 @@ void QCPGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataR
   if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in data (significantly simplifies following processing)
     std::reverse(data.begin(), data.end());
   
+  // transform data points to pixels, points with NaN values end up with NaN coordinates and are skipped by QCPScatterStyle::drawShapes:
   scatters->resize(data.size());
-  if (keyAxis->orientation() == Qt::Vertical)
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      if (!qIsNaN(data.at(i).value))
-      {
-        (*scatters)[i].setX(valueAxis->coordToPixel(data.at(i).value));
-        (*scatters)[i].setY(keyAxis->coordToPixel(data.at(i).key));
-      }
-    }
-  } else
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      if (!qIsNaN(data.at(i).value))
-      {
-        (*scatters)[i].setX(keyAxis->coordToPixel(data.at(i).key));
-        (*scatters)[i].setY(valueAxis->coordToPixel(data.at(i).value));
-      }
-    }
-  }
+  if (!data.isEmpty())
+    coordsToPixels(&data.constData()->key, &data.constData()->value, data.size(), sizeof(QCPGraphData)/sizeof(double), scatters->data());
 }
 
 /*! \internal
@@ -20577,21 +22849,8 @@ QVector<QPointF> QCPGraph::dataToLines(const QVector<QCPGraphData> &data) const
   result.resize(data.size());
   
   // transform data points to pixels:
-  if (keyAxis->orientation() == Qt::Vertical)
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      result[i].setX(valueAxis->coordToPixel(data.at(i).value));
-      result[i].setY(keyAxis->coordToPixel(data.at(i).key));
-    }
-  } else // key axis is horizontal
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      result[i].setX(keyAxis->coordToPixel(data.at(i).key));
-      result[i].setY(valueAxis->coordToPixel(data.at(i).value));
-    }
-  }
+  if (!data.isEmpty())
+    coordsToPixels(&data.constData()->key, &data.constData()->value, data.size(), sizeof(QCPGraphData)/sizeof(double), result.data());
   return result;
 }
 
@@ -20613,29 +22872,32 @@ QVector<QPointF> QCPGraph::dataToStepLeftLines(const QVector<QCPGraphData> &data
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
   
   result.resize(data.size()*2);
+  if (data.isEmpty())
+    return result;
   
-  // calculate steps from data and transform to pixel coordinates:
+  // transform data to pixel coordinates, then calculate steps from them:
+  const QVector<QPointF> points = dataToLines(data);
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    double lastValue = valueAxis->coordToPixel(data.first().value);
-    for (int i=0; i<data.size(); ++i)
+    double lastValue = points.first().x();
+    for (int i=0; i<points.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
+      const double key = points.at(i).y();
       result[i*2+0].setX(lastValue);
       result[i*2+0].setY(key);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
+      lastValue = points.at(i).x();
       result[i*2+1].setX(lastValue);
       result[i*2+1].setY(key);
     }
   } else // key axis is horizontal
   {
-    double lastValue = valueAxis->coordToPixel(data.first().value);
-    for (int i=0; i<data.size(); ++i)
+    double lastValue = points.first().y();
+    for (int i=0; i<points.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
+      const double key = points.at(i).x();
       result[i*2+0].setX(key);
       result[i*2+0].setY(lastValue);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
+      lastValue = points.at(i).y();
       result[i*2+1].setX(key);
       result[i*2+1].setY(lastValue);
     }
@@ -20661,29 +22923,32 @@ QVector<QPointF> QCPGraph::dataToStepRightLines(const QVector<QCPGraphData> &dat
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
   
   result.resize(data.size()*2);
+  if (data.isEmpty())
+    return result;
   
-  // calculate steps from data and transform to pixel coordinates:
+  // transform data to pixel coordinates, then calculate steps from them:
+  const QVector<QPointF> points = dataToLines(data);
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
-    for (int i=0; i<data.size(); ++i)
+    double lastKey = points.first().y();
+    for (int i=0; i<points.size(); ++i)
     {
-      const double value = valueAxis->coordToPixel(data.at(i).value);
+      const double value = points.at(i).x();
       result[i*2+0].setX(value);
       result[i*2+0].setY(lastKey);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastKey = points.at(i).y();
       result[i*2+1].setX(value);
       result[i*2+1].setY(lastKey);
     }
   } else // key axis is horizontal
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
-    for (int i=0; i<data.size(); ++i)
+    double lastKey = points.first().x();
+    for (int i=0; i<points.size(); ++i)
     {
-      const double value = valueAxis->coordToPixel(data.at(i).value);
+      const double value = points.at(i).y();
       result[i*2+0].setX(lastKey);
       result[i*2+0].setY(value);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastKey = points.at(i).x();
       result[i*2+1].setX(lastKey);
       result[i*2+1].setY(value);
     }
@@ -20709,44 +22974,47 @@ QVector<QPointF> QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &da
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
   
   result.resize(data.size()*2);
+  if (data.isEmpty())
+    return result;
   
-  // calculate steps from data and transform to pixel coordinates:
+  // transform data to pixel coordinates, then calculate steps from them:
+  const QVector<QPointF> points = dataToLines(data);
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
-    double lastValue = valueAxis->coordToPixel(data.first().value);
+    double lastKey = points.first().y();
+    double lastValue = points.first().x();
     result[0].setX(lastValue);
     result[0].setY(lastKey);
-    for (int i=1; i<data.size(); ++i)
+    for (int i=1; i<points.size(); ++i)
     {
-      const double key = (keyAxis->coordToPixel(data.at(i).key)+lastKey)*0.5;
+      const double key = (points.at(i).y()+lastKey)*0.5;
       result[i*2-1].setX(lastValue);
       result[i*2-1].setY(key);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastValue = points.at(i).x();
+      lastKey = points.at(i).y();
       result[i*2+0].setX(lastValue);
       result[i*2+0].setY(key);
     }
-    result[data.size()*2-1].setX(lastValue);
-    result[data.size()*2-1].setY(lastKey);
+    result[points.size()*2-1].setX(lastValue);
+    result[points.size()*2-1].setY(lastKey);
   } else // key axis is horizontal
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
-    double lastValue = valueAxis->coordToPixel(data.first().value);
+    double lastKey = points.first().x();
+    double lastValue = points.first().y();
     result[0].setX(lastKey);
     result[0].setY(lastValue);
-    for (int i=1; i<data.size(); ++i)
+    for (int i=1; i<points.size(); ++i)
     {
-      const double key = (keyAxis->coordToPixel(data.at(i).key)+lastKey)*0.5;
+      const double key = (points.at(i).x()+lastKey)*0.5;
       result[i*2-1].setX(key);
       result[i*2-1].setY(lastValue);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastValue = points.at(i).y();
+      lastKey = points.at(i).x();
       result[i*2+0].setX(key);
       result[i*2+0].setY(lastValue);
     }
-    result[data.size()*2-1].setX(lastKey);
-    result[data.size()*2-1].setY(lastValue);
+    result[points.size()*2-1].setX(lastKey);
+    result[points.size()*2-1].setY(lastValue);
   }
   return result;
 }
@@ -20770,26 +23038,24 @@ QVector<QPointF> QCPGraph::dataToImpulseLines(const QVector<QCPGraphData> &data)
   
   result.resize(data.size()*2);
   
-  // transform data points to pixels:
+  // transform data points to pixels, every impulse starts at the value zero:
+  const QVector<QPointF> points = dataToLines(data);
+  const double zeroValue = valueAxis->coordToPixel(0);
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    for (int i=0; i<data.size(); ++i)
+    for (int i=0; i<points.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
-      result[i*2+0].setX(valueAxis->coordToPixel(0));
-      result[i*2+0].setY(key);
-      result[i*2+1].setX(valueAxis->coordToPixel(data.at(i).value));
-      result[i*2+1].setY(key);
+      result[i*2+0].setX(zeroValue);
+      result[i*2+0].setY(points.at(i).y());
+      result[i*2+1] = points.at(i);
     }
   } else // key axis is horizontal
   {
-    for (int i=0; i<data.size(); ++i)
+    for (int i=0; i<points.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
-      result[i*2+0].setX(key);
-      result[i*2+0].setY(valueAxis->coordToPixel(0));
-      result[i*2+1].setX(key);
-      result[i*2+1].setY(valueAxis->coordToPixel(data.at(i).value));
+      result[i*2+0].setX(points.at(i).x());
+      result[i*2+0].setY(zeroValue);
+      result[i*2+1] = points.at(i);
     }
   }
   return result;
@@ -20850,8 +23116,7 @@ void QCPGraph::drawScatterPlot(QCPPainter *painter, const QVector<QPointF> &scat
 {
   applyScattersAntialiasingHint(painter);
   style.applyTo(painter, mPen);
-  for (int i=0; i<scatters.size(); ++i)
-    style.drawShape(painter, scatters.at(i).x(), scatters.at(i).y());
+  style.drawShapes(painter, scatters);
 }
 
 /*!  \internal
@@ -20865,8 +23130,125 @@ void QCPGraph::drawLinePlot(QCPPainter *painter, const QVector<QPointF> &lines)
   if (painter->pen().style() != Qt::NoPen && painter->pen().color().alpha() != 0)
   {
     applyDefaultAntialiasingHint(painter);
-    drawPolyline(painter, lines);
+    if (mBatchedLines && painter->pen().style() == Qt::SolidLine)
+      drawBatchedLines(painter, lines);
+    else
+      drawPolyline(painter, lines);
+  }
+}
+
+/*! \internal
+  
+  Draws the line through the points in \a lines, given in pixel coordinates, as a sequence of short
+  polylines which are clipped to the axis rect (extended by the pen width). Points with NaN or
+  infinite coordinates create a gap in the line.
+  
+  Consecutive segments that are visible are collected in a batch of at most \ref mLineBatchSize
+  points. A batch is drawn when it is full, or when the line leaves the clip rect or has a gap. A
+  full batch is continued by the next one at its last point, so the line stays connected.
+  
+  \see setBatchedLines, drawLinePlot
+*/
+void QCPGraph::drawBatchedLines(QCPPainter *painter, const QVector<QPointF> &lines) const
+{
+  const double penMargin = qMax(1.0, painter->pen().widthF());
+  const QRectF clip = QRectF(clipRect()).adjusted(-penMargin, -penMargin, penMargin, penMargin);
+  
+  QVector<QPointF> batch;
+  batch.reserve(mLineBatchSize);
+  QPointF previous;
+  bool havePrevious = false;
+  const int lineCount = lines.size();
+  for (int i=0; i<lineCount; ++i)
+  {
+    const QPointF &point = lines.at(i);
+    if (qIsNaN(point.x()) || qIsNaN(point.y()) || qIsInf(point.x()) || qIsInf(point.y())) // NaNs create a gap in the line
+    {
+      if (batch.size() > 1)
+        painter->drawPolyline(batch.constData(), batch.size());
+      batch.clear();
+      havePrevious = false;
+      continue;
+    }
+    if (!havePrevious)
+    {
+      previous = point;
+      havePrevious = true;
+      continue;
+    }
+    
+    QPointF start = previous;
+    QPointF end = point;
+    previous = point;
+    if (!clipLineSegment(start, end, clip))
+    {
+      if (batch.size() > 1)
+        painter->drawPolyline(batch.constData(), batch.size());
+      batch.clear();
+      continue;
+    }
+    if (batch.isEmpty() || batch.last() != start) // segment doesn't continue the current batch, because the line was clipped in between
+    {
+      if (batch.size() > 1)
+        painter->drawPolyline(batch.constData(), batch.size());
+      batch.clear();
+      batch.append(start);
+    }
+    batch.append(end);
+    if (batch.size() >= mLineBatchSize)
+    {
+      painter->drawPolyline(batch.constData(), batch.size());
+      batch.clear();
+      batch.append(end);
+    }
+  }
+  if (batch.size() > 1)
+    painter->drawPolyline(batch.constData(), batch.size());
+}
+
+/*! \internal
+  
+  Clips the line segment from \a start to \a end to \a rect, using the Liang-Barsky algorithm. The
+  end points are modified in place.
+  
+  Returns false if the segment lies completely outside \a rect. In that case, \a start and \a end
+  are left in an undefined state.
+*/
+bool QCPGraph::clipLineSegment(QPointF &start, QPointF &end, const QRectF &rect)
+{
+  const double dx = end.x()-start.x();
+  const double dy = end.y()-start.y();
+  const double p[4] = {-dx, dx, -dy, dy};
+  const double q[4] = {start.x()-rect.left(), rect.right()-start.x(), start.y()-rect.top(), rect.bottom()-start.y()};
+  double tEnter = 0;
+  double tLeave = 1;
+  for (int i=0; i<4; ++i)
+  {
+    if (p[i] == 0)
+    {
+      if (q[i] < 0) // parallel to this boundary and outside
+        return false;
+    } else
+    {
+      const double t = q[i]/p[i];
+      if (p[i] < 0)
+      {
+        if (t > tLeave) return false;
+        if (t > tEnter) tEnter = t;
+      } else
+      {
+        if (t < tEnter) return false;
+        if (t < tLeave) tLeave = t;
+      }
+    }
   }
+  // only modify points that were actually clipped, so unclipped segments continue each other exactly:
+  const QPointF origin = start;
+  if (tEnter > 0)
+    start = QPointF(origin.x()+tEnter*dx, origin.y()+tEnter*dy);
+  if (tLeave < 1)
+    end = QPointF(origin.x()+tLeave*dx, origin.y()+tLeave*dy);
+  return true;
 }
 
 /*! \internal
@@ -20913,15 +23295,19 @@ void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGr
   
   int dataCount = end-begin;
   int maxCount = (std::numeric_limits<int>::max)();
+  double keyPixelSpan = 0;
   if (mAdaptiveSampling)
   {
-    double keyPixelSpan = qAbs(keyAxis->coordToPixel(begin->key)-keyAxis->coordToPixel((end-1)->key));
+    keyPixelSpan = qAbs(keyAxis->coordToPixel(begin->key)-keyAxis->coordToPixel((end-1)->key));
     if (2*keyPixelSpan+2 < static_cast<double>((std::numeric_limits<int>::max)()))
       maxCount = 2*keyPixelSpan+2;
   }
   
   if (mAdaptiveSampling && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
   {
+    if (mLodPyramid && getLodLineData(lineData, begin, end, keyPixelSpan)) // summarized blocks of the pyramid are dense enough, no need to walk the data
+      return;
+    
     QCPGraphDataContainer::const_iterator it = begin;
     double minValue = it->value;
     double maxValue = it->value;
@@ -21628,76 +24014,690 @@ int QCPGraph::findIndexAboveY(const QVector<QPointF> *data, double y) const
   
   If either the graph has no data or if the line style is \ref lsNone and the scatter style's shape
   is \ref QCPScatterStyle::ssNone (i.e. there is no visual representation of the graph), returns -1.0.
+  
+  If the spatial index is enabled (\ref setSpatialIndex), the data points and line segments near \a
+  pixelPoint are looked up in the indices returned by \ref pointIndex and \ref lineIndex, instead
+  of transforming the data and generating the line on every call.
 */
 double QCPGraph::pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer::const_iterator &closestData) const
 {
-  closestData = mDataContainer->constEnd();
-  if (mDataContainer->isEmpty())
-    return -1.0;
-  if (mLineStyle == lsNone && mScatterStyle.isNone())
-    return -1.0;
+  closestData = mDataContainer->constEnd();
+  if (mDataContainer->isEmpty())
+    return -1.0;
+  if (mLineStyle == lsNone && mScatterStyle.isNone())
+    return -1.0;
+  
+  if (mSpatialIndex)
+  {
+    const double tolerance = mParentPlot->selectionTolerance();
+    double minDistSqr = (std::numeric_limits<double>::max)();
+    const int index = pointIndex().nearestPoint(pixelPoint, tolerance, &minDistSqr);
+    if (index >= 0)
+      closestData = mDataContainer->constBegin()+index;
+    if (mLineStyle != lsNone)
+      minDistSqr = qMin(minDistSqr, lineIndex().segmentDistanceSqr(pixelPoint, tolerance, mLineStyle==lsImpulse ? 2 : 1));
+    return qSqrt(minDistSqr);
+  }
+  
+  // calculate minimum distances to graph data points and find closestData iterator:
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  // determine which key range comes into question, taking selection tolerance around pos into account:
+  double posKeyMin, posKeyMax, dummy;
+  pixelsToCoords(pixelPoint-QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMin, dummy);
+  pixelsToCoords(pixelPoint+QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMax, dummy);
+  if (posKeyMin > posKeyMax)
+    qSwap(posKeyMin, posKeyMax);
+  // iterate over found data points and then choose the one with the shortest distance to pos:
+  QCPGraphDataContainer::const_iterator begin = mDataContainer->findBegin(posKeyMin, true);
+  QCPGraphDataContainer::const_iterator end = mDataContainer->findEnd(posKeyMax, true);
+  for (QCPGraphDataContainer::const_iterator it=begin; it!=end; ++it)
+  {
+    const double currentDistSqr = QCPVector2D(coordsToPixels(it->key, it->value)-pixelPoint).lengthSquared();
+    if (currentDistSqr < minDistSqr)
+    {
+      minDistSqr = currentDistSqr;
+      closestData = it;
+    }
+  }
+    
+  // calculate distance to graph line if there is one (if so, will probably be smaller than distance to closest data point):
+  if (mLineStyle != lsNone)
+  {
+    // line displayed, calculate distance to line segments:
+    QVector<QPointF> lineData;
+    getLines(&lineData, QCPDataRange(0, dataCount()));
+    QCPVector2D p(pixelPoint);
+    const int step = mLineStyle==lsImpulse ? 2 : 1; // impulse plot differs from other line styles in that the lineData points are only pairwise connected
+    for (int i=0; i<lineData.size()-1; i+=step)
+    {
+      const double currentDistSqr = p.distanceSquaredToLine(lineData.at(i), lineData.at(i+1));
+      if (currentDistSqr < minDistSqr)
+        minDistSqr = currentDistSqr;
+    }
+  }
+  
+  return qSqrt(minDistSqr);
+}
+
+/*! \internal
+  
+  Returns the spatial index of the graph line in pixel coordinates, as generated by \ref getLines
+  (see \ref setSpatialIndex). The index is rebuilt if the parent plot was replotted or the data was
+  modified or replaced since it was last built. The point indices of the line index don't
+  correspond to data indices.
+*/
+const QCPPixelColumnIndex &QCPGraph::lineIndex() const
+{
+  const int currentReplotCount = replotCount();
+  const quintptr dataSource = reinterpret_cast<quintptr>(mDataContainer.data());
+  if (!mLineIndex.isUpToDate(currentReplotCount, dataSource, mDataContainer->revision()))
+  {
+    QVector<QPointF> lineData;
+    getLines(&lineData, QCPDataRange(0, dataCount()));
+    mLineIndex.build(lineData, mKeyAxis.data()->orientation(), keyPixelRange(), 0, currentReplotCount, dataSource, mDataContainer->revision());
+  }
+  return mLineIndex;
+}
+
+/*! \internal
+
+  Brings the level-of-detail pyramid up to date with the data container (see \ref setLodPyramid).
+
+  If the data was only appended to since the last call, the new complete blocks are summarized and
+  merged into the upper levels, which costs amortized O(1) per added point. If points were removed
+  from the front, which is detected by finding the last summarized key at a lower index, the
+  blocks containing removed points are dropped (see \ref evictLodPoints). If the container was
+  exchanged, shrunk otherwise, or its first or last summarized key changed in another way (e.g.
+  due to removal at the back, prepending or inserting), the pyramid is rebuilt from scratch.
+
+  Blocks are numbered from the first data point at the time the pyramid was built, so blocks stay
+  aligned to their positions when points are removed from the front. Block \a i of level \a n
+  starts at data index <tt>(i*mLodBaseBucketSize << n) - mLodEvictedCount</tt>.
+*/
+void QCPGraph::updateLodPyramid() const
+{
+  QMutexLocker locker(&mLodMutex);
+  const int dataCount = mDataContainer->size();
+  const QCPGraphDataContainer::const_iterator dataBegin = mDataContainer->constBegin();
+  bool rebuild = mLodSource != mDataContainer.data();
+  if (!rebuild && mLodPointCount > 0 && (dataCount == 0 || dataBegin->key != mLodFirstKey))
+  {
+    // points were removed from the front if the last summarized point moved to a lower index:
+    int evictedCount = 0;
+    const std::pair<QCPGraphDataContainer::const_iterator, QCPGraphDataContainer::const_iterator> lastPoint =
+        std::equal_range(dataBegin, mDataContainer->constEnd(), QCPGraphData::fromSortKey(mLodLastKey), qcpLessThanSortKey<QCPGraphData>);
+    if (lastPoint.second-lastPoint.first == 1) // a key that is not unique can't tell how many points were removed
+      evictedCount = mLodPointCount-1-(lastPoint.first-dataBegin);
+    if (evictedCount > 0 && mLodEvictedCount < (1 << 30)) // rebuild once in a while, so block numbers can't overflow
+      evictLodPoints(evictedCount);
+    else
+      rebuild = true;
+  }
+  if (rebuild || mLodPointCount > dataCount || (mLodPointCount > 0 && (dataBegin+mLodPointCount-1)->key != mLodLastKey))
+  {
+    mLodLevels.clear();
+    mLodLevelOffsets.clear();
+    mLodSource = mDataContainer.data();
+    mLodPointCount = 0;
+    mLodEvictedCount = 0;
+  }
+  if (dataCount == mLodPointCount)
+    return;
+  
+  // summarize new complete blocks of raw data points into the base level:
+  if (mLodLevels.isEmpty())
+  {
+    mLodLevels.append(QVector<LodBucket>());
+    mLodLevelOffsets.append(0);
+  }
+  QVector<LodBucket> &baseLevel = mLodLevels[0];
+  const int baseOffset = mLodLevelOffsets.at(0);
+  const int baseEnd = (dataCount+mLodEvictedCount)/mLodBaseBucketSize;
+  baseLevel.reserve(baseEnd-baseOffset);
+  for (int i=baseOffset+baseLevel.size(); i<baseEnd; ++i)
+  {
+    QCPGraphDataContainer::const_iterator it = dataBegin+(i*mLodBaseBucketSize-mLodEvictedCount);
+    const QCPGraphDataContainer::const_iterator itEnd = it+mLodBaseBucketSize;
+    LodBucket bucket;
+    bucket.firstKey = it->key;
+    bucket.firstValue = it->value;
+    bucket.lastKey = (itEnd-1)->key;
+    bucket.lastValue = (itEnd-1)->value;
+    bucket.minKey = bucket.maxKey = it->key;
+    bucket.minValue = bucket.maxValue = it->value;
+    bucket.hasNan = false;
+    while (it != itEnd)
+    {
+      if (qIsNaN(it->value))
+        bucket.hasNan = true; // min/max of this bucket are never used, see appendLodBucket
+      else if (it->value < bucket.minValue)
+      {
+        bucket.minKey = it->key;
+        bucket.minValue = it->value;
+      } else if (it->value > bucket.maxValue)
+      {
+        bucket.maxKey = it->key;
+        bucket.maxValue = it->value;
+      }
+      ++it;
+    }
+    baseLevel.append(bucket);
+  }
+  
+  // merge pairs of blocks into the upper levels:
+  int level = 1;
+  while (mLodLevels.at(level-1).size() >= 2)
+  {
+    if (mLodLevels.size() <= level)
+    {
+      mLodLevels.append(QVector<LodBucket>());
+      const int blockSize = mLodBaseBucketSize << level;
+      mLodLevelOffsets.append((mLodEvictedCount+blockSize-1)/blockSize); // first block without removed points
+    }
+    const QVector<LodBucket> &lowerLevel = mLodLevels.at(level-1);
+    const int lowerOffset = mLodLevelOffsets.at(level-1);
+    QVector<LodBucket> &upperLevel = mLodLevels[level];
+    const int upperEnd = (lowerOffset+lowerLevel.size())/2;
+    for (int i=mLodLevelOffsets.at(level)+upperLevel.size(); i<upperEnd; ++i)
+      upperLevel.append(mergeLodBuckets(lowerLevel.at(2*i-lowerOffset), lowerLevel.at(2*i+1-lowerOffset)));
+    ++level;
+  }
+  
+  mLodPointCount = dataCount;
+  mLodFirstKey = dataBegin->key;
+  mLodLastKey = (dataBegin+dataCount-1)->key;
+}
+
+/*! \internal
+
+  Updates the level-of-detail pyramid after \a count points were removed from the front of the
+  data. Must be called with the pyramid mutex locked, i.e. from \ref updateLodPyramid.
+
+  Blocks containing removed points are no longer valid. They are dropped from the front of each
+  level once they make up half of it, so the cost is amortized O(1) per removed point. Until then,
+  they are skipped by \ref getLodLineData, since they start before the first data point.
+*/
+void QCPGraph::evictLodPoints(int count) const
+{
+  mLodEvictedCount += count;
+  mLodPointCount -= count;
+  for (int level=0; level<mLodLevels.size(); ++level)
+  {
+    const int blockSize = mLodBaseBucketSize << level;
+    const int firstValid = (mLodEvictedCount+blockSize-1)/blockSize;
+    const int invalidCount = qMin(firstValid-mLodLevelOffsets.at(level), mLodLevels.at(level).size());
+    if (invalidCount == mLodLevels.at(level).size())
+    {
+      mLodLevels[level].clear();
+      mLodLevelOffsets[level] = firstValid;
+    } else if (invalidCount > mLodLevels.at(level).size()/2)
+    {
+      mLodLevels[level].remove(0, invalidCount);
+      mLodLevelOffsets[level] += invalidCount;
+    }
+  }
+}
+
+/*! \internal
+
+  Fills \a lineData from the level-of-detail pyramid for the data between \a begin and \a end,
+  which spans \a keyPixelSpan pixels on the key axis. This is the fast path of \ref
+  getOptimizedLineData when \ref setLodPyramid is enabled.
+
+  The range is covered with the largest blocks that fit both the index alignment and the chosen
+  level, whose blocks hold at most as many points as fall on one pixel on average. So the middle of
+  the range is drawn at pixel resolution, and only a few finer blocks and less than one base block
+  of raw points are emitted at the borders.
+
+  Returns false without touching \a lineData if the pyramid can't be used or wouldn't reduce the
+  data, so the caller falls back to the regular adaptive sampling.
+*/
+bool QCPGraph::getLodLineData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end, double keyPixelSpan) const
+{
+  if (mKeyAxis.data()->scaleType() != QCPAxis::stLinear) // block sizes are chosen by average density, which is only meaningful on linear key axes
+    return false;
+  
+  updateLodPyramid();
+  const int dataCount = end-begin;
+  const double pointsPerPixel = dataCount/qMax(1.0, keyPixelSpan);
+  int maxLevel = -1;
+  while (maxLevel+1 < mLodLevels.size() && (mLodBaseBucketSize << (maxLevel+1)) <= pointsPerPixel)
+    ++maxLevel;
+  if (maxLevel < 0) // base blocks are larger than a pixel, the regular algorithm does better
+    return false;
+  
+  const QCPGraphDataContainer::const_iterator dataBegin = mDataContainer->constBegin();
+  const int endIndex = end-dataBegin;
+  int index = begin-dataBegin;
+  // blocks are numbered from the first point of the data the pyramid was built from, see updateLodPyramid:
+  lineData->reserve(4*dataCount/(mLodBaseBucketSize << maxLevel)+8*mLodBaseBucketSize);
+  while (index < endIndex)
+  {
+    int level = maxLevel;
+    while (level >= 0)
+    {
+      const int bucketSize = mLodBaseBucketSize << level;
+      const int block = (index+mLodEvictedCount)/bucketSize;
+      if ((index+mLodEvictedCount) % bucketSize == 0 && index+bucketSize <= endIndex &&
+          block >= mLodLevelOffsets.at(level) && block-mLodLevelOffsets.at(level) < mLodLevels.at(level).size())
+        break;
+      --level;
+    }
+    if (level >= 0)
+    {
+      appendLodBucket(lineData, level, (index+mLodEvictedCount)/(mLodBaseBucketSize << level));
+      index += mLodBaseBucketSize << level;
+    } else // not aligned to a block or not summarized yet, transfer the raw point
+    {
+      lineData->append(*(dataBegin+index));
+      ++index;
+    }
+  }
+  return true;
+}
+
+/*! \internal
+
+  Appends the points representing block \a index of pyramid \a level to \a lineData: its first
+  point, its minimum and maximum in key order, and its last point.
+
+  Blocks containing NaN values are resolved into their child blocks, down to the raw data points,
+  so gaps in the line are preserved exactly like without the pyramid.
+*/
+void QCPGraph::appendLodBucket(QVector<QCPGraphData> *lineData, int level, int index) const
+{
+  const LodBucket &bucket = mLodLevels.at(level).at(index-mLodLevelOffsets.at(level));
+  if (bucket.hasNan)
+  {
+    if (level > 0)
+    {
+      appendLodBucket(lineData, level-1, 2*index);
+      appendLodBucket(lineData, level-1, 2*index+1);
+    } else
+    {
+      QCPGraphDataContainer::const_iterator it = mDataContainer->constBegin()+(index*mLodBaseBucketSize-mLodEvictedCount);
+      const QCPGraphDataContainer::const_iterator itEnd = it+mLodBaseBucketSize;
+      for (; it != itEnd; ++it)
+        lineData->append(*it);
+    }
+    return;
+  }
+  
+  lineData->append(QCPGraphData(bucket.firstKey, bucket.firstValue));
+  if (bucket.minKey < bucket.maxKey)
+  {
+    lineData->append(QCPGraphData(bucket.minKey, bucket.minValue));
+    lineData->append(QCPGraphData(bucket.maxKey, bucket.maxValue));
+  } else
+  {
+    lineData->append(QCPGraphData(bucket.maxKey, bucket.maxValue));
+    lineData->append(QCPGraphData(bucket.minKey, bucket.minValue));
+  }
+  lineData->append(QCPGraphData(bucket.lastKey, bucket.lastValue));
+}
+
+/*! \internal
+
+  Returns the block summarizing the two adjacent blocks \a a and \a b, where \a a precedes \a b.
+*/
+QCPGraph::LodBucket QCPGraph::mergeLodBuckets(const LodBucket &a, const LodBucket &b)
+{
+  LodBucket result;
+  result.firstKey = a.firstKey;
+  result.firstValue = a.firstValue;
+  result.lastKey = b.lastKey;
+  result.lastValue = b.lastValue;
+  if (b.minValue < a.minValue)
+  {
+    result.minKey = b.minKey;
+    result.minValue = b.minValue;
+  } else
+  {
+    result.minKey = a.minKey;
+    result.minValue = a.minValue;
+  }
+  if (b.maxValue > a.maxValue)
+  {
+    result.maxKey = b.maxKey;
+    result.maxValue = b.maxValue;
+  } else
+  {
+    result.maxKey = a.maxKey;
+    result.maxValue = a.maxValue;
+  }
+  result.hasNan = a.hasNan || b.hasNan;
+  return result;
+}
+
+/*! \internal
+  
+  Finds the highest index of \a data, whose points y value is just below \a y. Assumes y values in
+  \a data points are ordered ascending, as is ensured by \ref getLines/\ref getScatters if the key
+  axis is vertical.
+
+  Used to calculate the channel fill polygon, see \ref getChannelFillPolygon.
+*/
+int QCPGraph::findIndexBelowY(const QVector<QPointF> *data, double y) const
+{
+  for (int i=0; i<data->size(); ++i)
+  {
+    if (data->at(i).y() > y)
+    {
+      if (i>0)
+        return i-1;
+      else
+        return 0;
+    }
+  }
+  return -1;
+}
+
+/*! \internal
+  
+  Returns the current state of the axes, data and relevant properties of this graph, which
+  determines the pixel buffers of the background preparation (see \ref setBackgroundPreparation).
+*/
+QCPGraph::PreparationState QCPGraph::preparationState() const
+{
+  PreparationState state;
+  state.keyTransform = AxisTransform::fromAxis(mKeyAxis.data());
+  state.valueTransform = AxisTransform::fromAxis(mValueAxis.data());
+  state.dataSource = reinterpret_cast<quintptr>(mDataContainer.data());
+  state.dataRevision = mDataContainer->revision();
+  state.lineStyle = mLineStyle;
+  state.scatters = !mScatterStyle.isNone();
+  state.scatterSkip = mScatterSkip;
+  state.adaptiveSampling = mAdaptiveSampling;
+  return state;
+}
+
+/*! \internal
+  
+  Draws the graph from the buffers prepared in the background (see \ref setBackgroundPreparation).
+  Takes over the buffers of a finished preparation task, and starts a new task if the buffers don't
+  match the current state of the graph and no task is running yet.
+  
+  If the buffers were prepared for different axis ranges or axis rect geometry, the points are
+  transformed to the current ones. This is possible because the pixel coordinate of each axis is an
+  affine function of the (logarithmic) coordinate, as long as orientation and scale type are
+  unchanged.
+  
+  Returns false if the graph can't be drawn this way, e.g. because no buffers are prepared yet. The
+  caller then draws the graph synchronously.
+*/
+bool QCPGraph::drawPreparedBuffers(QCPPainter *painter, const QCPDataRange &clipDataRange)
+{
+  if ((mLineStyle != lsLine && mLineStyle != lsNone) || !mSelection.isEmpty() ||
+      painter->modes().testFlag(QCPPainter::pmVectorized) || clipDataRange != mDataContainer->dataRange())
+    return false;
+  
+  const PreparationState state = preparationState();
+  {
+    QMutexLocker locker(&mPreparationHandoff->mutex);
+    mPreparationHandoff->graph = this;
+    if (mPreparationHandoff->hasResult)
+    {
+      qSwap(mPreparedBuffers, mPreparationHandoff->result);
+      mPreparationHandoff->hasResult = false;
+    }
+    if (!(mPreparedBuffers.valid && mPreparedBuffers.state == state) && !mPreparationHandoff->running)
+    {
+      // the task gets its own copy of the visible data, so later changes of the container (e.g. by addData) don't need to detach a shared buffer:
+      QCPGraphDataContainer::const_iterator begin, end;
+      getVisibleDataBounds(begin, end, mDataContainer->dataRange());
+      QVector<QCPGraphData> visibleData(end-begin);
+      std::copy(begin, end, visibleData.begin());
+      mPreparationHandoff->running = true;
+      QThreadPool::globalInstance()->start(new QCPGraphPreparationTask(mPreparationHandoff, visibleData, state));
+    }
+  }
+  if (!mPreparedBuffers.valid)
+    return false;
+  
+  QVector<QPointF> lines = mPreparedBuffers.lines;
+  QVector<QPointF> scatters = mPreparedBuffers.scatters;
+  if (!(mPreparedBuffers.state == state))
+  {
+    // map the pixels of the prepared axis transforms to the current ones, via the pixels of the prepared range bounds:
+    const AxisTransform *prepared[2] = {&mPreparedBuffers.state.keyTransform, &mPreparedBuffers.state.valueTransform};
+    const AxisTransform *current[2] = {&state.keyTransform, &state.valueTransform};
+    double scale[2], offset[2];
+    for (int i=0; i<2; ++i)
+    {
+      if (prepared[i]->horizontal != current[i]->horizontal || prepared[i]->logarithmic != current[i]->logarithmic)
+        return false;
+      const double p1 = prepared[i]->coordToPixel(prepared[i]->range.lower);
+      const double p2 = prepared[i]->coordToPixel(prepared[i]->range.upper);
+      if (p1 == p2)
+        return false;
+      const double q1 = current[i]->coordToPixel(prepared[i]->range.lower);
+      const double q2 = current[i]->coordToPixel(prepared[i]->range.upper);
+      scale[i] = (q2-q1)/(p2-p1);
+      offset[i] = q1-scale[i]*p1;
+    }
+    const int xIndex = state.keyTransform.horizontal ? 0 : 1;
+    const int yIndex = 1-xIndex;
+    for (int i=0; i<lines.size(); ++i)
+      lines[i] = QPointF(lines.at(i).x()*scale[xIndex]+offset[xIndex], lines.at(i).y()*scale[yIndex]+offset[yIndex]);
+    for (int i=0; i<scatters.size(); ++i)
+      scatters[i] = QPointF(scatters.at(i).x()*scale[xIndex]+offset[xIndex], scatters.at(i).y()*scale[yIndex]+offset[yIndex]);
+  }
+  
+  painter->setBrush(mBrush);
+  painter->setPen(Qt::NoPen);
+  drawFill(painter, &lines);
+  if (mLineStyle != lsNone)
+  {
+    painter->setPen(mPen);
+    painter->setBrush(Qt::NoBrush);
+    drawLinePlot(painter, lines);
+  }
+  if (!mScatterStyle.isNone())
+    drawScatterPlot(painter, scatters, mScatterStyle);
+  return true;
+}
+
+/*! \internal
+  
+  Called on the GUI thread when a preparation task has finished, to show its result with the next
+  replot.
+*/
+void QCPGraph::preparationFinished()
+{
+  if (mBackgroundPreparation && mParentPlot)
+  {
+    markLayerDirty(); // the axes may be unchanged, so with QCP::phDirtyLayerReplot the layer would not be redrawn otherwise
+    mParentPlot->replot(QCustomPlot::rpQueuedReplot);
+  }
+}
+
+/*! \internal
+  
+  Returns the transform of \a axis from coordinates to pixels, as a value that can be used on
+  other threads. The transform is the same as the one of \ref QCPAxis::coordToPixel.
+*/
+QCPGraph::AxisTransform QCPGraph::AxisTransform::fromAxis(const QCPAxis *axis)
+{
+  AxisTransform result;
+  if (!axis || !axis->axisRect())
+    return result;
+  result.horizontal = axis->orientation() == Qt::Horizontal;
+  result.logarithmic = axis->scaleType() == QCPAxis::stLogarithmic;
+  result.reversed = axis->rangeReversed();
+  result.range = axis->range();
+  result.rect = axis->axisRect()->rect();
+  
+  // the transform has the form pixel = base + factor*f(value), like the batch transform QCPAxis::coordToPixel:
+  const QRect &rect = result.rect;
+  result.origin = result.reversed ? result.range.upper : result.range.lower;
+  result.base = result.horizontal ? rect.left() : rect.bottom();
+  const double extent = (result.horizontal ? rect.width() : -rect.height())*(result.reversed ? -1 : 1);
+  if (result.logarithmic)
+  {
+    result.factor = extent/qLn(result.range.upper/result.range.lower);
+    result.upperOutside = result.horizontal ? (!result.reversed ? rect.right()+200 : rect.left()-200) : (!result.reversed ? rect.top()-200 : rect.bottom()+200);
+    result.lowerOutside = result.horizontal ? (!result.reversed ? rect.left()-200 : rect.right()+200) : (!result.reversed ? rect.bottom()+200 : rect.top()-200);
+  } else
+    result.factor = extent/result.range.size();
+  return result;
+}
+
+/*! \internal
+  
+  Transforms \a value from axis coordinates to pixels.
+*/
+double QCPGraph::AxisTransform::coordToPixel(double value) const
+{
+  if (!logarithmic)
+    return (value-origin)*factor+base;
+  if (value >= 0.0 && range.upper < 0.0) // invalid value for logarithmic scale, just draw it outside visible range
+    return upperOutside;
+  if (value <= 0.0 && range.upper >= 0.0)
+    return lowerOutside;
+  return qLn(value/origin)*factor+base;
+}
+
+/*! \internal
+  
+  Returns whether this state equals \a other.
+*/
+bool QCPGraph::PreparationState::operator==(const PreparationState &other) const
+{
+  return keyTransform == other.keyTransform && valueTransform == other.valueTransform &&
+      dataSource == other.dataSource && dataRevision == other.dataRevision &&
+      lineStyle == other.lineStyle && scatters == other.scatters &&
+      scatterSkip == other.scatterSkip && adaptiveSampling == other.adaptiveSampling;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPGraphPreparationTask
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPGraphPreparationTask
+  \brief Prepares the pixel buffers of a graph on a thread pool
+
+  This is an internal class used by QCPGraph when \ref QCPGraph::setBackgroundPreparation is
+  enabled. It works on a copy of the visible data and a snapshot of the axis transforms, so the
+  graph may be changed or deleted while the task is running. The result is handed over to the graph via a shared, mutex
+  guarded buffer, and the graph is notified with a queued call.
+*/
+
+/*!
+  Creates a task that prepares the pixel buffers for the visible data points \a data, according to
+  \a state. The result is stored in \a handoff.
+*/
+QCPGraphPreparationTask::QCPGraphPreparationTask(const QSharedPointer<QCPGraph::PreparationHandoff> &handoff, const QVector<QCPGraphData> &data, const QCPGraph::PreparationState &state) :
+  mHandoff(handoff),
+  mData(data),
+  mState(state)
+{
+}
+
+/* inherits documentation from base class */
+void QCPGraphPreparationTask::run()
+{
+  QCPGraph::PreparedBuffers result;
+  result.valid = true;
+  result.state = mState;
+  const QCPGraphDataContainer::const_iterator begin = mData.constBegin();
+  const QCPGraphDataContainer::const_iterator end = mData.constEnd();
+  const QCPGraph::AxisTransform &keyTransform = mState.keyTransform;
   
-  // calculate minimum distances to graph data points and find closestData iterator:
-  double minDistSqr = (std::numeric_limits<double>::max)();
-  // determine which key range comes into question, taking selection tolerance around pos into account:
-  double posKeyMin, posKeyMax, dummy;
-  pixelsToCoords(pixelPoint-QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMin, dummy);
-  pixelsToCoords(pixelPoint+QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMax, dummy);
-  if (posKeyMin > posKeyMax)
-    qSwap(posKeyMin, posKeyMax);
-  // iterate over found data points and then choose the one with the shortest distance to pos:
-  QCPGraphDataContainer::const_iterator begin = mDataContainer->findBegin(posKeyMin, true);
-  QCPGraphDataContainer::const_iterator end = mDataContainer->findEnd(posKeyMax, true);
-  for (QCPGraphDataContainer::const_iterator it=begin; it!=end; ++it)
+  if (mState.lineStyle == QCPGraph::lsLine && begin != end)
   {
-    const double currentDistSqr = QCPVector2D(coordsToPixels(it->key, it->value)-pixelPoint).lengthSquared();
-    if (currentDistSqr < minDistSqr)
+    QVector<QCPGraphData> lineData;
+    if (mState.adaptiveSampling) // keep first, minimum, maximum and last data point per key pixel
     {
-      minDistSqr = currentDistSqr;
-      closestData = it;
+      QCPGraphDataContainer::const_iterator first = begin, minIt = begin, maxIt = begin, last = begin;
+      double binIndex = 0;
+      bool binOpen = false;
+      for (QCPGraphDataContainer::const_iterator it = begin; it != end; ++it)
+      {
+        if (qIsNaN(it->value))
+        {
+          if (binOpen)
+            QCPGraph::appendDecimationBin(&lineData, first, minIt, maxIt, last);
+          binOpen = false;
+          lineData.append(*it);
+          continue;
+        }
+        const double index = floor(keyTransform.coordToPixel(it->key));
+        if (binOpen && index == binIndex)
+        {
+          if (it->value < minIt->value)
+            minIt = it;
+          if (it->value > maxIt->value)
+            maxIt = it;
+          last = it;
+        } else
+        {
+          if (binOpen)
+            QCPGraph::appendDecimationBin(&lineData, first, minIt, maxIt, last);
+          first = minIt = maxIt = last = it;
+          binIndex = index;
+          binOpen = true;
+        }
+      }
+      if (binOpen)
+        QCPGraph::appendDecimationBin(&lineData, first, minIt, maxIt, last);
+    } else
+    {
+      lineData.resize(end-begin);
+      std::copy(begin, end, lineData.begin());
     }
-  }
+    if (keyTransform.reversed != !keyTransform.horizontal) // make sure key pixels are sorted ascending, like QCPGraph::getLines
+      std::reverse(lineData.begin(), lineData.end());
     
-  // calculate distance to graph line if there is one (if so, will probably be smaller than distance to closest data point):
-  if (mLineStyle != lsNone)
+    result.lines.resize(lineData.size());
+    for (int i=0; i<lineData.size(); ++i)
+      result.lines[i] = toPixels(lineData.at(i).key, lineData.at(i).value);
+  }
+  
+  if (mState.scatters && begin != end)
   {
-    // line displayed, calculate distance to line segments:
-    QVector<QPointF> lineData;
-    getLines(&lineData, QCPDataRange(0, dataCount()));
-    QCPVector2D p(pixelPoint);
-    const int step = mLineStyle==lsImpulse ? 2 : 1; // impulse plot differs from other line styles in that the lineData points are only pairwise connected
-    for (int i=0; i<lineData.size()-1; i+=step)
+    const int step = mState.scatterSkip+1;
+    result.scatters.reserve(mData.size()/step+1);
+    QPoint lastPixel;
+    bool haveLastPixel = false;
+    for (int i=0; i<mData.size(); i+=step)
     {
-      const double currentDistSqr = p.distanceSquaredToLine(lineData.at(i), lineData.at(i+1));
-      if (currentDistSqr < minDistSqr)
-        minDistSqr = currentDistSqr;
+      const QCPGraphData &point = mData.at(i);
+      if (qIsNaN(point.value))
+        continue;
+      const QPointF pixel = toPixels(point.key, point.value);
+      if (mState.adaptiveSampling) // successive points on the same pixel would be drawn on top of each other
+      {
+        if (haveLastPixel && pixel.toPoint() == lastPixel)
+          continue;
+        lastPixel = pixel.toPoint();
+        haveLastPixel = true;
+      }
+      result.scatters.append(pixel);
     }
   }
   
-  return qSqrt(minDistSqr);
+  QMutexLocker locker(&mHandoff->mutex);
+  qSwap(mHandoff->result, result);
+  mHandoff->hasResult = true;
+  mHandoff->running = false;
+  if (mHandoff->graph)
+    QMetaObject::invokeMethod(mHandoff->graph, "preparationFinished", Qt::QueuedConnection);
 }
 
 /*! \internal
   
-  Finds the highest index of \a data, whose points y value is just below \a y. Assumes y values in
-  \a data points are ordered ascending, as is ensured by \ref getLines/\ref getScatters if the key
-  axis is vertical.
-
-  Used to calculate the channel fill polygon, see \ref getChannelFillPolygon.
+  Transforms the data point at \a key and \a value to pixel coordinates, using the axis transforms
+  of the snapshot.
 */
-int QCPGraph::findIndexBelowY(const QVector<QPointF> *data, double y) const
+QPointF QCPGraphPreparationTask::toPixels(double key, double value) const
 {
-  for (int i=0; i<data->size(); ++i)
-  {
-    if (data->at(i).y() > y)
-    {
-      if (i>0)
-        return i-1;
-      else
-        return 0;
-    }
-  }
-  return -1;
+  const double keyPixel = mState.keyTransform.coordToPixel(key);
+  const double valuePixel = mState.valueTransform.coordToPixel(value);
+  if (mState.keyTransform.horizontal)
+    return QPointF(keyPixel, valuePixel);
+  else
+    return QPointF(valuePixel, keyPixel);
 }
 /* end of 'src/plottables/plottable-graph.cpp' */
 
@@ -21861,7 +24861,11 @@ QCPCurveData::QCPCurveData(double t, double key, double value) :
   but use QCustomPlot::removePlottable() instead.
 */
 QCPCurve::QCPCurve(QCPAxis *keyAxis, QCPAxis *valueAxis) :
-  QCPAbstractPlottable1D<QCPCurveData>(keyAxis, valueAxis)
+  QCPAbstractPlottable1D<QCPCurveData>(keyAxis, valueAxis),
+  mStreaming(false),
+  mStreamSource(0),
+  mStreamCount(0),
+  mStreamRegion(5)
 {
   // modify inherited properties from abstract plottable:
   setPen(QPen(Qt::blue, 0));
@@ -21894,6 +24898,7 @@ QCPCurve::~QCPCurve()
 void QCPCurve::setData(QSharedPointer<QCPCurveDataContainer> data)
 {
   mDataContainer = data;
+  markLayerDirty();
 }
 
 /*! \overload
@@ -21909,6 +24914,7 @@ void QCPCurve::setData(QSharedPointer<QCPCurveDataContainer> data)
 */
 void QCPCurve::setData(const QVector<double> &t, const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
 {
+  mStreamCount = 0;
   mDataContainer->clear();
   addData(t, keys, values, alreadySorted);
 }
@@ -21927,6 +24933,7 @@ void QCPCurve::setData(const QVector<double> &t, const QVector<double> &keys, co
 */
 void QCPCurve::setData(const QVector<double> &keys, const QVector<double> &values)
 {
+  mStreamCount = 0;
   mDataContainer->clear();
   addData(keys, values);
 }
@@ -21971,6 +24978,38 @@ void QCPCurve::setLineStyle(QCPCurve::LineStyle style)
   mLineStyle = style;
 }
 
+/*!
+  Sets whether this curve is optimized for data that grows by appending points, e.g. a phase plot
+  of two quantities of a running measurement.
+  
+  Normally, the curve clips its whole data to the visible region on every replot. With streaming
+  enabled, the clipped line is kept between replots, together with the clipping state of the last
+  processed point. As long as the axes are unchanged and data is only appended (with increasing
+  \a t, as done by \ref addData(double key, double value)), a replot only processes the new data
+  points. Additionally, consecutive visible points that are less than half a pixel apart from the
+  previously kept point are dropped, so dense curves don't produce more line points than pixels
+  they pass.
+  
+  Changing the axis ranges, the axis rect size, the pen width or the data in another way than
+  appending causes the line to be built anew on the next replot. Segments with selected data are
+  always drawn with the regular clipping.
+  
+  Unlike the regular clipping, a streaming curve is treated as open, i.e. the virtual segment from
+  the last back to the first data point isn't considered. This only matters for curves with a fill
+  (\ref setBrush) that extend beyond the axis rect.
+  
+  Since the kept line is updated while drawing, layers containing streaming curves are never drawn
+  tiled (see \ref QCP::phTiledRaster).
+  
+  By default, streaming is disabled.
+*/
+void QCPCurve::setStreaming(bool enabled)
+{
+  mStreaming = enabled;
+  mStreamCount = 0;
+  mStreamLines.clear();
+}
+
 /*! \overload
   
   Adds the provided points in \a t, \a keys and \a values to the current data. The provided vectors
@@ -22001,6 +25040,7 @@ void QCPCurve::addData(const QVector<double> &t, const QVector<double> &keys, co
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markLayerDirty();
 }
 
 /*! \overload
@@ -22038,6 +25078,7 @@ void QCPCurve::addData(const QVector<double> &keys, const QVector<double> &value
     ++i;
   }
   mDataContainer->add(tempData, true); // don't modify tempData beyond this to prevent copy on write
+  markLayerDirty();
 }
 
 /*! \overload
@@ -22049,6 +25090,7 @@ void QCPCurve::addData(const QVector<double> &keys, const QVector<double> &value
 void QCPCurve::addData(double t, double key, double value)
 {
   mDataContainer->add(QCPCurveData(t, key, value));
+  markLayerDirty();
 }
 
 /*! \overload
@@ -22067,6 +25109,7 @@ void QCPCurve::addData(double key, double value)
     mDataContainer->add(QCPCurveData((mDataContainer->constEnd()-1)->t + 1.0, key, value));
   else
     mDataContainer->add(QCPCurveData(0.0, key, value));
+  markLayerDirty();
 }
 
 /*!
@@ -22132,7 +25175,10 @@ void QCPCurve::draw(QCPPainter *painter)
       finalCurvePen = mSelectionDecorator->pen();
     
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getCurveLines takes care)
-    getCurveLines(&lines, lineDataRange, finalCurvePen.widthF());
+    if (mStreaming && !isSelectedSegment && lineDataRange.contains(mDataContainer->dataRange()))
+      getStreamingCurveLines(&lines, finalCurvePen.widthF());
+    else
+      getCurveLines(&lines, lineDataRange, finalCurvePen.widthF());
     
     // check data validity if flag set:
   #ifdef QCUSTOMPLOT_CHECK_DATA
@@ -22240,9 +25286,7 @@ void QCPCurve::drawScatterPlot(QCPPainter *painter, const QVector<QPointF> &poin
   // draw scatter point symbols:
   applyScattersAntialiasingHint(painter);
   style.applyTo(painter, mPen);
-  for (int i=0; i<points.size(); ++i)
-    if (!qIsNaN(points.at(i).x()) && !qIsNaN(points.at(i).y()))
-      style.drawShape(painter,  points.at(i));
+  style.drawShapes(painter, points);
 }
 
 /*! \internal
@@ -22356,6 +25400,111 @@ void QCPCurve::getCurveLines(QVector<QPointF> *lines, const QCPDataRange &dataRa
   *lines << trailingPoints;
 }
 
+/*! \internal
+  
+  Returns the line of the whole curve in \a lines, like \ref getCurveLines, for curves with \ref
+  setStreaming enabled. The clipped line and the clipping state of the last processed point are
+  kept between calls, so only data points appended since the previous call are processed, as long
+  as the axes and \a penWidth are unchanged.
+  
+  Visible points that are less than half a pixel away from the last added point are skipped.
+*/
+void QCPCurve::getStreamingCurveLines(QVector<QPointF> *lines, double penWidth)
+{
+  if (!lines) return;
+  lines->clear();
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  
+  // the previously processed points can be reused if the transform to pixels and the processed data are unchanged:
+  QVector<double> state;
+  const QRect axisRect = keyAxis->axisRect()->rect();
+  state << keyAxis->range().lower << keyAxis->range().upper << keyAxis->scaleType() << keyAxis->rangeReversed() << keyAxis->orientation()
+        << valueAxis->range().lower << valueAxis->range().upper << valueAxis->scaleType() << valueAxis->rangeReversed()
+        << axisRect.left() << axisRect.top() << axisRect.width() << axisRect.height() << penWidth;
+  const int dataCount = mDataContainer->size();
+  const QCPCurveDataContainer::const_iterator itBegin = mDataContainer->constBegin();
+  const QCPCurveDataContainer::const_iterator itEnd = mDataContainer->constEnd();
+  bool resume = mStreamCount > 0 && mStreamCount <= dataCount && state == mStreamState && mStreamSource == mDataContainer.data();
+  if (resume)
+  {
+    const QCPCurveData &first = *itBegin;
+    const QCPCurveData &last = *(itBegin+mStreamCount-1);
+    resume = first.t == mStreamFirst.t && first.key == mStreamFirst.key && first.value == mStreamFirst.value &&
+             last.t == mStreamLast.t && last.key == mStreamLast.key && last.value == mStreamLast.value;
+  }
+  if (!resume)
+  {
+    mStreamState = state;
+    mStreamSource = mDataContainer.data();
+    mStreamCount = 0;
+    mStreamLines.clear();
+  }
+  
+  // add margins to rect to compensate for stroke width, like getCurveLines
+  const double strokeMargin = qMax(qreal(1.0), qreal(penWidth*0.75)); // stroke radius + 50% safety
+  const double keyMin = keyAxis->pixelToCoord(keyAxis->coordToPixel(keyAxis->range().lower)-strokeMargin*keyAxis->pixelOrientation());
+  const double keyMax = keyAxis->pixelToCoord(keyAxis->coordToPixel(keyAxis->range().upper)+strokeMargin*keyAxis->pixelOrientation());
+  const double valueMin = valueAxis->pixelToCoord(valueAxis->coordToPixel(valueAxis->range().lower)-strokeMargin*valueAxis->pixelOrientation());
+  const double valueMax = valueAxis->pixelToCoord(valueAxis->coordToPixel(valueAxis->range().upper)+strokeMargin*valueAxis->pixelOrientation());
+  
+  QCPCurveDataContainer::const_iterator it = itBegin+mStreamCount;
+  if (mStreamCount == 0 && it != itEnd) // first point has no predecessor, it only starts the line if it is visible
+  {
+    mStreamRegion = getRegion(it->key, it->value, keyMin, valueMax, keyMax, valueMin);
+    if (mStreamRegion == 5)
+      mStreamLines.append(coordsToPixels(it->key, it->value));
+    mStreamFirst = *it;
+    ++it;
+  }
+  while (it != itEnd)
+  {
+    const QCPCurveDataContainer::const_iterator prevIt = it-1;
+    const int currentRegion = getRegion(it->key, it->value, keyMin, valueMax, keyMax, valueMin);
+    if (currentRegion != mStreamRegion) // changed region, same handling as in getCurveLines
+    {
+      if (currentRegion != 5)
+      {
+        QPointF crossA, crossB;
+        if (mStreamRegion == 5)
+        {
+          mStreamLines.append(getOptimizedPoint(currentRegion, it->key, it->value, prevIt->key, prevIt->value, keyMin, valueMax, keyMax, valueMin));
+          mStreamLines << getOptimizedCornerPoints(mStreamRegion, currentRegion, prevIt->key, prevIt->value, it->key, it->value, keyMin, valueMax, keyMax, valueMin);
+        } else if (mayTraverse(mStreamRegion, currentRegion) &&
+                   getTraverse(prevIt->key, prevIt->value, it->key, it->value, keyMin, valueMax, keyMax, valueMin, crossA, crossB))
+        {
+          QVector<QPointF> beforeTraverseCornerPoints, afterTraverseCornerPoints;
+          getTraverseCornerPoints(mStreamRegion, currentRegion, keyMin, valueMax, keyMax, valueMin, beforeTraverseCornerPoints, afterTraverseCornerPoints);
+          mStreamLines << beforeTraverseCornerPoints;
+          mStreamLines.append(crossA);
+          mStreamLines.append(crossB);
+          mStreamLines << afterTraverseCornerPoints;
+        } else
+        {
+          mStreamLines << getOptimizedCornerPoints(mStreamRegion, currentRegion, prevIt->key, prevIt->value, it->key, it->value, keyMin, valueMax, keyMax, valueMin);
+        }
+      } else
+      {
+        mStreamLines.append(getOptimizedPoint(mStreamRegion, prevIt->key, prevIt->value, it->key, it->value, keyMin, valueMax, keyMax, valueMin));
+        mStreamLines.append(coordsToPixels(it->key, it->value));
+      }
+    } else if (currentRegion == 5) // still in R, add the point unless it lies on the pixel of the last added point
+    {
+      const QPointF pixel = coordsToPixels(it->key, it->value);
+      const QPointF lastPixel = mStreamLines.isEmpty() ? QPointF(qQNaN(), qQNaN()) : mStreamLines.last();
+      if (!(qAbs(pixel.x()-lastPixel.x()) < 0.5 && qAbs(pixel.y()-lastPixel.y()) < 0.5)) // written negated, so NaN coordinates are always added
+        mStreamLines.append(pixel);
+    }
+    mStreamRegion = currentRegion;
+    ++it;
+  }
+  mStreamCount = dataCount;
+  if (dataCount > 0)
+    mStreamLast = *(itEnd-1);
+  *lines = mStreamLines;
+}
+
 /*! \internal
 
   Called by \ref draw to generate points in pixel coordinates which represent the scatters of the
@@ -23688,6 +26837,7 @@ QCPBars::~QCPBars()
 void QCPBars::setData(QSharedPointer<QCPBarsDataContainer> data)
 {
   mDataContainer = data;
+  markLayerDirty();
 }
 
 /*! \overload
@@ -23804,6 +26954,7 @@ void QCPBars::addData(const QVector<double> &keys, const QVector<double> &values
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markLayerDirty();
 }
 
 /*! \overload
@@ -23815,6 +26966,7 @@ void QCPBars::addData(const QVector<double> &keys, const QVector<double> &values
 void QCPBars::addData(double key, double value)
 {
   mDataContainer->add(QCPBarsData(key, value));
+  markLayerDirty();
 }
 
 /*!
@@ -24564,6 +27716,7 @@ QCPStatisticalBox::QCPStatisticalBox(QCPAxis *keyAxis, QCPAxis *valueAxis) :
 void QCPStatisticalBox::setData(QSharedPointer<QCPStatisticalBoxDataContainer> data)
 {
   mDataContainer = data;
+  markLayerDirty();
 }
 /*! \overload
   
@@ -24700,6 +27853,7 @@ void QCPStatisticalBox::addData(const QVector<double> &keys, const QVector<doubl
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markLayerDirty();
 }
 
 /*! \overload
@@ -24713,6 +27867,7 @@ void QCPStatisticalBox::addData(const QVector<double> &keys, const QVector<doubl
 void QCPStatisticalBox::addData(double key, double minimum, double lowerQuartile, double median, double upperQuartile, double maximum, const QVector<double> &outliers)
 {
   mDataContainer->add(QCPStatisticalBoxData(key, minimum, lowerQuartile, median, upperQuartile, maximum, outliers));
+  markLayerDirty();
 }
 
 /*!
@@ -25017,6 +28172,10 @@ QVector<QLineF> QCPStatisticalBox::getWhiskerBarLines(QCPStatisticalBoxDataConta
   coordinate with \ref setData. plot coordinate to cell index transformations and vice versa are
   provided by the functions \ref coordToCell and \ref cellToCoord.
   
+  For rolling displays like spectrograms, where new data arrives as a column of value cells at a
+  time, use \ref appendColumn. It overwrites the oldest key column in place and shifts the key
+  range, so neither the data array nor the color map image need to be moved or fully recolorized.
+  
   A \ref QCPColorMapData also holds an on-demand two-dimensional array of alpha values which (if
   allocated) has the same size as the data map. It can be accessed via \ref setAlpha, \ref
   fillAlpha and \ref clearAlpha. The memory for the alpha map is only allocated if needed, i.e. on
@@ -25059,7 +28218,12 @@ QCPColorMapData::QCPColorMapData(int keySize, int valueSize, const QCPRange &key
   mIsEmpty(true),
   mData(0),
   mAlpha(0),
-  mDataModified(true)
+  mKeyOffset(0),
+  mDataModified(true),
+  mModifiedKeyBegin(0),
+  mModifiedKeyEnd(std::numeric_limits<int>::max()),
+  mModifiedValueBegin(0),
+  mModifiedValueEnd(std::numeric_limits<int>::max())
 {
   setSize(keySize, valueSize);
   fill(0);
@@ -25082,7 +28246,12 @@ QCPColorMapData::QCPColorMapData(const QCPColorMapData &other) :
   mIsEmpty(true),
   mData(0),
   mAlpha(0),
-  mDataModified(true)
+  mKeyOffset(0),
+  mDataModified(true),
+  mModifiedKeyBegin(0),
+  mModifiedKeyEnd(std::numeric_limits<int>::max()),
+  mModifiedValueBegin(0),
+  mModifiedValueEnd(std::numeric_limits<int>::max())
 {
   *this = other;
 }
@@ -25109,8 +28278,9 @@ QCPColorMapData &QCPColorMapData::operator=(const QCPColorMapData &other)
       if (mAlpha)
         memcpy(mAlpha, other.mAlpha, sizeof(mAlpha[0])*keySize*valueSize);
     }
+    mKeyOffset = other.mKeyOffset;
     mDataBounds = other.mDataBounds;
-    mDataModified = true;
+    setAllModified();
   }
   return *this;
 }
@@ -25121,7 +28291,7 @@ double QCPColorMapData::data(double key, double value)
   int keyCell = (key-mKeyRange.lower)/(mKeyRange.upper-mKeyRange.lower)*(mKeySize-1)+0.5;
   int valueCell = (value-mValueRange.lower)/(mValueRange.upper-mValueRange.lower)*(mValueSize-1)+0.5;
   if (keyCell >= 0 && keyCell < mKeySize && valueCell >= 0 && valueCell < mValueSize)
-    return mData[valueCell*mKeySize + keyCell];
+    return mData[valueCell*mKeySize + physicalKeyIndex(keyCell)];
   else
     return 0;
 }
@@ -25130,7 +28300,7 @@ double QCPColorMapData::data(double key, double value)
 double QCPColorMapData::cell(int keyIndex, int valueIndex)
 {
   if (keyIndex >= 0 && keyIndex < mKeySize && valueIndex >= 0 && valueIndex < mValueSize)
-    return mData[valueIndex*mKeySize + keyIndex];
+    return mData[valueIndex*mKeySize + physicalKeyIndex(keyIndex)];
   else
     return 0;
 }
@@ -25146,7 +28316,7 @@ double QCPColorMapData::cell(int keyIndex, int valueIndex)
 unsigned char QCPColorMapData::alpha(int keyIndex, int valueIndex)
 {
   if (mAlpha && keyIndex >= 0 && keyIndex < mKeySize && valueIndex >= 0 && valueIndex < mValueSize)
-    return mAlpha[valueIndex*mKeySize + keyIndex];
+    return mAlpha[valueIndex*mKeySize + physicalKeyIndex(keyIndex)];
   else
     return 255;
 }
@@ -25169,6 +28339,7 @@ void QCPColorMapData::setSize(int keySize, int valueSize)
   {
     mKeySize = keySize;
     mValueSize = valueSize;
+    mKeyOffset = 0;
     if (mData)
       delete[] mData;
     mIsEmpty = mKeySize == 0 || mValueSize == 0;
@@ -25191,7 +28362,7 @@ void QCPColorMapData::setSize(int keySize, int valueSize)
     if (mAlpha) // if we had an alpha map, recreate it with new size
       createAlpha();
     
-    mDataModified = true;
+    setAllModified();
   }
 }
 
@@ -25289,12 +28460,13 @@ void QCPColorMapData::setData(double key, double value, double z)
   int valueCell = (value-mValueRange.lower)/(mValueRange.upper-mValueRange.lower)*(mValueSize-1)+0.5;
   if (keyCell >= 0 && keyCell < mKeySize && valueCell >= 0 && valueCell < mValueSize)
   {
-    mData[valueCell*mKeySize + keyCell] = z;
+    const int physicalKeyCell = physicalKeyIndex(keyCell);
+    mData[valueCell*mKeySize + physicalKeyCell] = z;
     if (z < mDataBounds.lower)
       mDataBounds.lower = z;
     if (z > mDataBounds.upper)
       mDataBounds.upper = z;
-     mDataModified = true;
+    setRegionModified(physicalKeyCell, physicalKeyCell+1, valueCell, valueCell+1);
   }
 }
 
@@ -25313,12 +28485,13 @@ void QCPColorMapData::setCell(int keyIndex, int valueIndex, double z)
 {
   if (keyIndex >= 0 && keyIndex < mKeySize && valueIndex >= 0 && valueIndex < mValueSize)
   {
-    mData[valueIndex*mKeySize + keyIndex] = z;
+    const int physicalKey = physicalKeyIndex(keyIndex);
+    mData[valueIndex*mKeySize + physicalKey] = z;
     if (z < mDataBounds.lower)
       mDataBounds.lower = z;
     if (z > mDataBounds.upper)
       mDataBounds.upper = z;
-     mDataModified = true;
+    setRegionModified(physicalKey, physicalKey+1, valueIndex, valueIndex+1);
   } else
     qDebug() << Q_FUNC_INFO << "index out of bounds:" << keyIndex << valueIndex;
 }
@@ -25344,8 +28517,9 @@ void QCPColorMapData::setAlpha(int keyIndex, int valueIndex, unsigned char alpha
   {
     if (mAlpha || createAlpha())
     {
-      mAlpha[valueIndex*mKeySize + keyIndex] = alpha;
-      mDataModified = true;
+      const int physicalKey = physicalKeyIndex(keyIndex);
+      mAlpha[valueIndex*mKeySize + physicalKey] = alpha;
+      setRegionModified(physicalKey, physicalKey+1, valueIndex, valueIndex+1);
     }
   } else
     qDebug() << Q_FUNC_INFO << "index out of bounds:" << keyIndex << valueIndex;
@@ -25402,7 +28576,7 @@ void QCPColorMapData::clearAlpha()
   {
     delete[] mAlpha;
     mAlpha = 0;
-    mDataModified = true;
+    setAllModified();
   }
 }
 
@@ -25415,7 +28589,7 @@ void QCPColorMapData::fill(double z)
   for (int i=0; i<dataCount; ++i)
     mData[i] = z;
   mDataBounds = QCPRange(z, z);
-  mDataModified = true;
+  setAllModified();
 }
 
 /*!
@@ -25434,7 +28608,7 @@ void QCPColorMapData::fillAlpha(unsigned char alpha)
     const int dataCount = mValueSize*mKeySize;
     for (int i=0; i<dataCount; ++i)
       mAlpha[i] = alpha;
-    mDataModified = true;
+    setAllModified();
   }
 }
 
@@ -25486,6 +28660,66 @@ void QCPColorMapData::cellToCoord(int keyIndex, int valueIndex, double *key, dou
     *value = valueIndex/(double)(mValueSize-1)*(mValueRange.upper-mValueRange.lower)+mValueRange.lower;
 }
 
+/*!
+  Appends a column of value cells at the upper end of the key range and drops the column at the
+  lower end. \a values must point to \ref valueSize values, ordered by value index.
+  
+  The key range is shifted by one cell width, so the appended column ends up at the same key
+  coordinate as the previous last column plus the key distance between two cells. If you want to
+  keep the key range fixed (e.g. for a "time ago" axis), set it again with \ref setKeyRange after
+  the call.
+  
+  The data is stored in a circular fashion: the new column overwrites the memory of the dropped
+  one, and the color map only recolorizes the pixels of that column on the next replot. So the cost
+  of this method and of the following map image update is proportional to \ref valueSize, not to
+  the total cell count. This makes it suitable for rolling displays such as live spectrograms.
+  
+  If an alpha map exists, the appended cells are fully opaque. The buffered data bounds are
+  expanded by the new values as with \ref setCell.
+  
+  \see setCell
+*/
+void QCPColorMapData::appendColumn(const double *values)
+{
+  if (isEmpty() || !mData)
+    return;
+  
+  // the oldest column becomes the newest:
+  const int physicalKey = mKeyOffset;
+  mKeyOffset = mKeyOffset+1 < mKeySize ? mKeyOffset+1 : 0;
+  for (int i=0; i<mValueSize; ++i)
+  {
+    const double z = values[i];
+    mData[i*mKeySize + physicalKey] = z;
+    if (z < mDataBounds.lower)
+      mDataBounds.lower = z;
+    if (z > mDataBounds.upper)
+      mDataBounds.upper = z;
+  }
+  if (mAlpha)
+  {
+    for (int i=0; i<mValueSize; ++i)
+      mAlpha[i*mKeySize + physicalKey] = 255;
+  }
+  if (mKeySize > 1)
+    mKeyRange += mKeyRange.size()/(double)(mKeySize-1);
+  setRegionModified(physicalKey, physicalKey+1, 0, mValueSize);
+}
+
+/*! \overload
+  
+  Appends the column \a values, which must contain \ref valueSize values.
+*/
+void QCPColorMapData::appendColumn(const QVector<double> &values)
+{
+  if (values.size() != mValueSize)
+  {
+    qDebug() << Q_FUNC_INFO << "column size doesn't match value size:" << values.size() << mValueSize;
+    return;
+  }
+  appendColumn(values.constData());
+}
+
 /*! \internal
 
   Allocates the internal alpha map with the current data map key/value size and, if \a
@@ -25524,6 +28758,50 @@ bool QCPColorMapData::createAlpha(bool initializeOpaque)
   }
 }
 
+/*! \internal
+  
+  Marks the whole data as modified, so the next map image update of the owning \ref QCPColorMap
+  recolorizes all cells.
+  
+  \see setRegionModified
+*/
+void QCPColorMapData::setAllModified()
+{
+  mDataModified = true;
+  mModifiedKeyBegin = 0;
+  mModifiedKeyEnd = std::numeric_limits<int>::max();
+  mModifiedValueBegin = 0;
+  mModifiedValueEnd = std::numeric_limits<int>::max();
+}
+
+/*! \internal
+  
+  Marks the cells with physical key indices \a keyBegin up to (excluding) \a keyEnd and value
+  indices \a valueBegin up to (excluding) \a valueEnd as modified. The modified region is extended
+  to the bounding box of all regions marked since the last map image update, so \ref
+  QCPColorMap::updateMapImage only needs to recolorize that part of the image. This makes frequent
+  updates of single rows or columns (e.g. of a spectrogram) cheap.
+  
+  \see setAllModified
+*/
+void QCPColorMapData::setRegionModified(int keyBegin, int keyEnd, int valueBegin, int valueEnd)
+{
+  if (mDataModified)
+  {
+    mModifiedKeyBegin = qMin(mModifiedKeyBegin, keyBegin);
+    mModifiedKeyEnd = qMax(mModifiedKeyEnd, keyEnd);
+    mModifiedValueBegin = qMin(mModifiedValueBegin, valueBegin);
+    mModifiedValueEnd = qMax(mModifiedValueEnd, valueEnd);
+  } else
+  {
+    mModifiedKeyBegin = keyBegin;
+    mModifiedKeyEnd = keyEnd;
+    mModifiedValueBegin = valueBegin;
+    mModifiedValueEnd = valueEnd;
+    mDataModified = true;
+  }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPColorMap
@@ -25655,6 +28933,7 @@ QCPColorMap::QCPColorMap(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   mGradient(QCPColorGradient::gpCold),
   mInterpolate(true),
   mTightBoundary(false),
+  mMapImageKeyOffset(0),
   mMapImageInvalidated(true)
 {
 }
@@ -25687,6 +28966,7 @@ void QCPColorMap::setData(QCPColorMapData *data, bool copy)
     mMapData = data;
   }
   mMapImageInvalidated = true;
+  markLayerDirty();
 }
 
 /*!
@@ -25707,6 +28987,7 @@ void QCPColorMap::setDataRange(const QCPRange &dataRange)
     else
       mDataRange = dataRange.sanitizedForLinScale();
     mMapImageInvalidated = true;
+    markLayerDirty();
     emit dataRangeChanged(mDataRange);
   }
 }
@@ -25722,6 +29003,7 @@ void QCPColorMap::setDataScaleType(QCPAxis::ScaleType scaleType)
   {
     mDataScaleType = scaleType;
     mMapImageInvalidated = true;
+    markLayerDirty();
     emit dataScaleTypeChanged(mDataScaleType);
     if (mDataScaleType == QCPAxis::stLogarithmic)
       setDataRange(mDataRange.sanitizedForLogScale());
@@ -25745,6 +29027,7 @@ void QCPColorMap::setGradient(const QCPColorGradient &gradient)
   {
     mGradient = gradient;
     mMapImageInvalidated = true;
+    markLayerDirty();
     emit gradientChanged(mGradient);
   }
 }
@@ -25759,6 +29042,7 @@ void QCPColorMap::setInterpolate(bool enabled)
 {
   mInterpolate = enabled;
   mMapImageInvalidated = true; // because oversampling factors might need to change
+  markLayerDirty();
 }
 
 /*!
@@ -25775,6 +29059,7 @@ void QCPColorMap::setInterpolate(bool enabled)
 void QCPColorMap::setTightBoundary(bool enabled)
 {
   mTightBoundary = enabled;
+  markLayerDirty();
 }
 
 /*!
@@ -25867,7 +29152,18 @@ void QCPColorMap::updateLegendIcon(Qt::TransformationMode transformMode, const Q
   {
     bool mirrorX = (keyAxis()->orientation() == Qt::Horizontal ? keyAxis() : valueAxis())->rangeReversed();
     bool mirrorY = (valueAxis()->orientation() == Qt::Vertical ? valueAxis() : keyAxis())->rangeReversed();
-    mLegendIcon = QPixmap::fromImage(mMapImage.mirrored(mirrorX, mirrorY)).scaled(thumbSize, Qt::KeepAspectRatio, transformMode);
+    if (mMapImageKeyOffset == 0)
+    {
+      mLegendIcon = QPixmap::fromImage(mMapImage.mirrored(mirrorX, mirrorY)).scaled(thumbSize, Qt::KeepAspectRatio, transformMode);
+    } else // key columns are stored circularly, let drawMapImage put them in order
+    {
+      QImage orderedImage(mMapImage.size(), mMapImage.format());
+      QPainter imagePainter(&orderedImage);
+      imagePainter.setCompositionMode(QPainter::CompositionMode_Source);
+      drawMapImage(&imagePainter, orderedImage.rect(), mirrorX, mirrorY);
+      imagePainter.end();
+      mLegendIcon = QPixmap::fromImage(orderedImage).scaled(thumbSize, Qt::KeepAspectRatio, transformMode);
+    }
   }
 }
 
@@ -25972,12 +29268,18 @@ void QCPColorMap::updateMapImage()
   const int valueSize = mMapData->valueSize();
   int keyOversamplingFactor = mInterpolate ? 1 : (int)(1.0+100.0/(double)keySize); // make mMapImage have at least size 100, factor becomes 1 if size > 200 or interpolation is on
   int valueOversamplingFactor = mInterpolate ? 1 : (int)(1.0+100.0/(double)valueSize); // make mMapImage have at least size 100, factor becomes 1 if size > 200 or interpolation is on
+  bool reallocated = false; // if an image is (re)allocated, its previous content can't be reused and all cells must be colorized
   
   // resize mMapImage to correct dimensions including possible oversampling factors, according to key/value axes orientation:
   if (keyAxis->orientation() == Qt::Horizontal && (mMapImage.width() != keySize*keyOversamplingFactor || mMapImage.height() != valueSize*valueOversamplingFactor))
+  {
     mMapImage = QImage(QSize(keySize*keyOversamplingFactor, valueSize*valueOversamplingFactor), format);
-  else if (keyAxis->orientation() == Qt::Vertical && (mMapImage.width() != valueSize*valueOversamplingFactor || mMapImage.height() != keySize*keyOversamplingFactor))
+    reallocated = true;
+  } else if (keyAxis->orientation() == Qt::Vertical && (mMapImage.width() != valueSize*valueOversamplingFactor || mMapImage.height() != keySize*keyOversamplingFactor))
+  {
     mMapImage = QImage(QSize(valueSize*valueOversamplingFactor, keySize*keyOversamplingFactor), format);
+    reallocated = true;
+  }
   
   if (mMapImage.isNull())
   {
@@ -25991,39 +29293,78 @@ void QCPColorMap::updateMapImage()
     {
       // resize undersampled map image to actual key/value cell sizes:
       if (keyAxis->orientation() == Qt::Horizontal && (mUndersampledMapImage.width() != keySize || mUndersampledMapImage.height() != valueSize))
+      {
         mUndersampledMapImage = QImage(QSize(keySize, valueSize), format);
-      else if (keyAxis->orientation() == Qt::Vertical && (mUndersampledMapImage.width() != valueSize || mUndersampledMapImage.height() != keySize))
+        reallocated = true;
+      } else if (keyAxis->orientation() == Qt::Vertical && (mUndersampledMapImage.width() != valueSize || mUndersampledMapImage.height() != keySize))
+      {
         mUndersampledMapImage = QImage(QSize(valueSize, keySize), format);
+        reallocated = true;
+      }
       localMapImage = &mUndersampledMapImage; // make the colorization run on the undersampled image
     } else if (!mUndersampledMapImage.isNull())
       mUndersampledMapImage = QImage(); // don't need oversampling mechanism anymore (map size has changed) but mUndersampledMapImage still has nonzero size, free it
     
-    const double *rawData = mMapData->mData;
-    const unsigned char *rawAlpha = mMapData->mAlpha;
+    // determine the region that needs to be colorized. If only the data changed since the last
+    // update, that's the modified region tracked by mMapData, otherwise everything. The image holds
+    // the key columns in their physical (circular) order, drawMapImage puts them in order:
+    int keyBegin = 0;
+    int keyEnd = keySize;
+    int valueBegin = 0;
+    int valueEnd = valueSize;
+    if (!mMapImageInvalidated && !reallocated)
+    {
+      keyBegin = qBound(0, mMapData->mModifiedKeyBegin, keySize);
+      keyEnd = qBound(keyBegin, mMapData->mModifiedKeyEnd, keySize);
+      valueBegin = qBound(0, mMapData->mModifiedValueBegin, valueSize);
+      valueEnd = qBound(valueBegin, mMapData->mModifiedValueEnd, valueSize);
+    }
+    
+    // lines are image scanlines, cells are the pixels within a line:
+    int lineCount, firstLine, endLine, firstCell, endCell;
     if (keyAxis->orientation() == Qt::Horizontal)
     {
-      const int lineCount = valueSize;
-      const int rowCount = keySize;
-      for (int line=0; line<lineCount; ++line)
-      {
-        QRgb* pixels = reinterpret_cast<QRgb*>(localMapImage->scanLine(lineCount-1-line)); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
-        if (rawAlpha)
-          mGradient.colorize(rawData+line*rowCount, rawAlpha+line*rowCount, mDataRange, pixels, rowCount, 1, mDataScaleType==QCPAxis::stLogarithmic);
-        else
-          mGradient.colorize(rawData+line*rowCount, mDataRange, pixels, rowCount, 1, mDataScaleType==QCPAxis::stLogarithmic);
-      }
+      lineCount = valueSize;
+      firstLine = valueBegin;
+      endLine = valueEnd;
+      firstCell = keyBegin;
+      endCell = keyEnd;
     } else // keyAxis->orientation() == Qt::Vertical
     {
-      const int lineCount = keySize;
-      const int rowCount = valueSize;
-      for (int line=0; line<lineCount; ++line)
+      lineCount = keySize;
+      firstLine = keyBegin;
+      endLine = keyEnd;
+      firstCell = valueBegin;
+      endCell = valueEnd;
+    }
+    
+    if (endLine > firstLine && endCell > firstCell)
+    {
+      // make sure worker threads only read the color buffer, and detach the image once on this thread:
+      if (mGradient.mColorBufferInvalidated)
+        mGradient.updateColorBuffer();
+      uchar *bits = localMapImage->bits();
+      const int bytesPerLine = localMapImage->bytesPerLine();
+      
+      // split large maps into chunks of lines which are colorized in parallel:
+      const qint64 minCellsPerChunk = 65536;
+      const qint64 cellCount = qint64(endLine-firstLine)*(endCell-firstCell);
+      int chunkCount = 1;
+      if (cellCount >= 2*minCellsPerChunk)
+        chunkCount = (int)qMin(qMin(qint64(QThread::idealThreadCount()), qint64(endLine-firstLine)), cellCount/minCellsPerChunk);
+      if (chunkCount > 1)
       {
-        QRgb* pixels = reinterpret_cast<QRgb*>(localMapImage->scanLine(lineCount-1-line)); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
-        if (rawAlpha)
-          mGradient.colorize(rawData+line, rawAlpha+line, mDataRange, pixels, rowCount, lineCount, mDataScaleType==QCPAxis::stLogarithmic);
-        else
-          mGradient.colorize(rawData+line, mDataRange, pixels, rowCount, lineCount, mDataScaleType==QCPAxis::stLogarithmic);
-      }
+        QSemaphore done;
+        for (int chunk=1; chunk<chunkCount; ++chunk)
+        {
+          const int chunkBegin = firstLine + (endLine-firstLine)*chunk/chunkCount;
+          const int chunkEnd = firstLine + (endLine-firstLine)*(chunk+1)/chunkCount;
+          QThreadPool::globalInstance()->start(new QCPColorMapColorizeTask(this, bits, bytesPerLine, lineCount, chunkBegin, chunkEnd, firstCell, endCell, &done));
+        }
+        colorizeLines(bits, bytesPerLine, lineCount, firstLine, firstLine + (endLine-firstLine)/chunkCount, firstCell, endCell);
+        done.acquire(chunkCount-1);
+      } else
+        colorizeLines(bits, bytesPerLine, lineCount, firstLine, endLine, firstCell, endCell);
     }
     
     if (keyOversamplingFactor > 1 || valueOversamplingFactor > 1)
@@ -26034,10 +29375,104 @@ void QCPColorMap::updateMapImage()
         mMapImage = mUndersampledMapImage.scaled(valueSize*valueOversamplingFactor, keySize*keyOversamplingFactor, Qt::IgnoreAspectRatio, Qt::FastTransformation);
     }
   }
+  mMapImageKeyOffset = mMapData->mKeyOffset;
   mMapData->mDataModified = false;
   mMapImageInvalidated = false;
 }
 
+/*! \internal
+  
+  Colorizes the image lines \a firstLine up to (excluding) \a endLine of an image with \a lineCount
+  scanlines, starting at \a bits with \a bytesPerLine. Within each line, only the pixels \a
+  firstCell up to (excluding) \a endCell are written. Lines are counted from the bottom of the
+  image, like the value axis.
+  
+  Since it only reads the map data and the (already updated) color buffer of the gradient, and
+  writes disjoint lines, this method may be called concurrently for non-overlapping line ranges.
+  This is done by \ref updateMapImage via \ref QCPColorMapColorizeTask.
+*/
+void QCPColorMap::colorizeLines(uchar *bits, int bytesPerLine, int lineCount, int firstLine, int endLine, int firstCell, int endCell)
+{
+  const bool keyHorizontal = mKeyAxis.data()->orientation() == Qt::Horizontal;
+  const bool logarithmic = mDataScaleType == QCPAxis::stLogarithmic;
+  const int keySize = mMapData->keySize();
+  const int cellCount = endCell-firstCell;
+  const int dataIndexFactor = keyHorizontal ? 1 : keySize;
+  const double *rawData = mMapData->mData;
+  const unsigned char *rawAlpha = mMapData->mAlpha;
+  for (int line=firstLine; line<endLine; ++line)
+  {
+    QRgb* pixels = reinterpret_cast<QRgb*>(bits + (lineCount-1-line)*bytesPerLine) + firstCell; // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
+    const int dataIndex = keyHorizontal ? line*keySize + firstCell : line + firstCell*keySize;
+    if (rawAlpha)
+      mGradient.colorize(rawData+dataIndex, rawAlpha+dataIndex, mDataRange, pixels, cellCount, dataIndexFactor, logarithmic);
+    else
+      mGradient.colorize(rawData+dataIndex, mDataRange, pixels, cellCount, dataIndexFactor, logarithmic);
+  }
+}
+
+/*! \internal
+  
+  Draws the map image into \a targetRect with \a painter, mirrored horizontally and/or vertically
+  as given by \a mirrorX and \a mirrorY.
+  
+  If columns were appended to the map data with \ref QCPColorMapData::appendColumn, the key
+  columns in the image are stored circularly, starting at the key offset the image was updated
+  with. In that case, the image is drawn as two parts which are placed such that the key columns
+  appear in order, without copying the image.
+*/
+void QCPColorMap::drawMapImage(QPainter *painter, const QRectF &targetRect, bool mirrorX, bool mirrorY) const
+{
+  const int keySize = mKeyAxis.data()->orientation() == Qt::Horizontal ? mMapImage.width() : mMapImage.height();
+  const int cellSize = mMapData->keySize() > 0 ? keySize/mMapData->keySize() : 1; // pixels per key cell, larger than one if the image is oversampled
+  const int splitPixel = mMapImageKeyOffset*cellSize; // physical key columns before this pixel are the newest ones
+  if (splitPixel <= 0 || splitPixel >= keySize)
+  {
+    painter->drawImage(targetRect, mMapImage.mirrored(mirrorX, mirrorY));
+    return;
+  }
+  
+  // apply mirroring via the painter transform, so the image parts can be drawn without copying:
+  painter->save();
+  painter->translate(targetRect.center());
+  painter->scale(mirrorX ? -1 : 1, mirrorY ? -1 : 1);
+  painter->translate(-targetRect.center());
+  const double newFraction = splitPixel/(double)keySize;
+  if (mKeyAxis.data()->orientation() == Qt::Horizontal)
+  {
+    // the newest columns are on the left of the image and belong to the right of the target:
+    const double splitX = targetRect.left() + targetRect.width()*(1.0-newFraction);
+    painter->drawImage(QRectF(targetRect.left(), targetRect.top(), splitX-targetRect.left(), targetRect.height()), mMapImage,
+                       QRectF(splitPixel, 0, keySize-splitPixel, mMapImage.height()));
+    painter->drawImage(QRectF(splitX, targetRect.top(), targetRect.right()-splitX, targetRect.height()), mMapImage,
+                       QRectF(0, 0, splitPixel, mMapImage.height()));
+  } else // keyAxis orientation is Qt::Vertical
+  {
+    // image rows count from the top while key indices count from the bottom. So the newest columns
+    // are at the bottom of the image and belong to the top of the target:
+    const double splitY = targetRect.top() + targetRect.height()*newFraction;
+    painter->drawImage(QRectF(targetRect.left(), targetRect.top(), targetRect.width(), splitY-targetRect.top()), mMapImage,
+                       QRectF(0, keySize-splitPixel, mMapImage.width(), splitPixel));
+    painter->drawImage(QRectF(targetRect.left(), splitY, targetRect.width(), targetRect.bottom()-splitY), mMapImage,
+                       QRectF(0, 0, mMapImage.width(), keySize-splitPixel));
+  }
+  painter->restore();
+}
+
+/*! \internal
+
+  Returns whether the map image doesn't reflect the current data, i.e. the data was modified or the
+  image was invalidated since the last \ref updateMapImage.
+
+  The map data may be modified directly (see \ref data), which can't mark the layer of this color
+  map as dirty. So with \ref QCP::phDirtyLayerReplot, \ref QCustomPlot::replot uses this to decide
+  whether the layer needs to be redrawn.
+*/
+bool QCPColorMap::mapImageOutdated() const
+{
+  return mMapImageInvalidated || mMapData->mDataModified;
+}
+
 /* inherits documentation from base class */
 void QCPColorMap::draw(QCPPainter *painter)
 {
@@ -26095,7 +29530,7 @@ void QCPColorMap::draw(QCPPainter *painter)
                                   coordsToPixels(mMapData->keyRange().upper, mMapData->valueRange().upper)).normalized();
     localPainter->setClipRect(tightClipRect, Qt::IntersectClip);
   }
-  localPainter->drawImage(imageRect, mMapImage.mirrored(mirrorX, mirrorY));
+  drawMapImage(localPainter, imageRect, mirrorX, mirrorY);
   if (mTightBoundary)
     localPainter->setClipRegion(clipBackup);
   localPainter->setRenderHint(QPainter::SmoothPixmapTransform, smoothBackup);
@@ -26126,6 +29561,43 @@ void QCPColorMap::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
   painter->drawRect(rect.adjusted(1, 1, 0, 0));
   */
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPColorMapColorizeTask
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPColorMapColorizeTask
+  \brief Colorizes a range of lines of a color map image on a thread pool
+
+  This is an internal class used by \ref QCPColorMap::updateMapImage to split the colorization of
+  large maps across multiple threads. It calls \ref QCPColorMap::colorizeLines and releases the
+  semaphore passed to the constructor once it's done.
+*/
+
+/*!
+  Creates a task that colorizes the lines \a firstLine up to (excluding) \a endLine of \a colorMap.
+  The parameters are passed on to \ref QCPColorMap::colorizeLines. After the lines are colorized,
+  one resource of \a done is released.
+*/
+QCPColorMapColorizeTask::QCPColorMapColorizeTask(QCPColorMap *colorMap, uchar *bits, int bytesPerLine, int lineCount, int firstLine, int endLine, int firstCell, int endCell, QSemaphore *done) :
+  mColorMap(colorMap),
+  mBits(bits),
+  mBytesPerLine(bytesPerLine),
+  mLineCount(lineCount),
+  mFirstLine(firstLine),
+  mEndLine(endLine),
+  mFirstCell(firstCell),
+  mEndCell(endCell),
+  mDone(done)
+{
+}
+
+/* inherits documentation from base class */
+void QCPColorMapColorizeTask::run()
+{
+  mColorMap->colorizeLines(mBits, mBytesPerLine, mLineCount, mFirstLine, mEndLine, mFirstCell, mEndCell);
+  mDone->release();
+}
 /* end of 'src/plottables/plottable-colormap.cpp' */
 
 
@@ -26341,6 +29813,7 @@ QCPFinancial::~QCPFinancial()
 void QCPFinancial::setData(QSharedPointer<QCPFinancialDataContainer> data)
 {
   mDataContainer = data;
+  markLayerDirty();
 }
 
 /*! \overload
@@ -26495,6 +29968,7 @@ void QCPFinancial::addData(const QVector<double> &keys, const QVector<double> &o
     ++i;
   }
   mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  markLayerDirty();
 }
 
 /*! \overload
@@ -26510,6 +29984,7 @@ void QCPFinancial::addData(const QVector<double> &keys, const QVector<double> &o
 void QCPFinancial::addData(double key, double open, double high, double low, double close)
 {
   mDataContainer->add(QCPFinancialData(key, open, high, low, close));
+  markLayerDirty();
 }
 
 /*!
@@ -65,6 +65,14 @@
 #include <QtCore/QStack>
 #include <QtCore/QCache>
 #include <QtCore/QMargins>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QFileInfo>
+#include <QtGui/QPicture>
+#include <QtGui/QImage>
 #include <qmath.h>
 #include <limits>
 #include <algorithm>
@@ -89,10 +97,12 @@
 #  include <QtNumeric>
 #  include <QtWidgets/QWidget>
 #  include <QtPrintSupport/QtPrintSupport>
+#  include <QtGui/QPdfWriter>
 #endif
 
 class QCPPainter;
 class QCustomPlot;
+class QCPPlotGroup;
 class QCPLayerable;
 class QCPLayoutElement;
 class QCPLayout;
@@ -242,7 +252,11 @@ enum PlottingHint { phNone              = 0x000 ///< <tt>0x000</tt> No hints are
                                                 ///<                joins, thus is most effective for pen sizes larger than 1. It is only used for solid line pens.
                     ,phImmediateRefresh = 0x002 ///< <tt>0x002</tt> causes an immediate repaint() instead of a soft update() when QCustomPlot::replot() is called with parameter \ref QCustomPlot::rpRefreshHint.
                                                 ///<                This is set by default to prevent the plot from freezing on fast consecutive replots (e.g. user drags ranges with mouse).
-                    ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as pixmaps, increasing replot performance.
+                    ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as pixmaps in a cache shared by all axes and plots, increasing replot performance.
+                    ,phDirtyLayerReplot = 0x008 ///< <tt>0x008</tt> \ref QCustomPlot::replot only redraws the paint buffers of layers marked dirty (\ref QCPLayer::markDirty), as long as the
+                                                ///<                viewport, the layout and all axis ranges are unchanged since the previous replot. Adding data to a plottable marks its layer dirty.
+                    ,phTiledRaster      = 0x010 ///< <tt>0x010</tt> Layers holding only plottables are rasterized in horizontal tiles on multiple threads and then composited into their paint buffer.
+                                                ///<                This scales full replots of large plots across CPU cores. Has no effect with OpenGL.
                   };
 Q_DECLARE_FLAGS(PlottingHints, PlottingHint)
 
@@ -538,6 +552,7 @@ public:
   virtual void donePainting() {}
   virtual void draw(QCPPainter *painter) const = 0;
   virtual void clear(const QColor &color) = 0;
+  virtual bool scroll(int dx, int dy, const QRect &rect);
   
 protected:
   // property members:
@@ -562,6 +577,7 @@ public:
   virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
   virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
   void clear(const QColor &color) Q_DECL_OVERRIDE;
+  virtual bool scroll(int dx, int dy, const QRect &rect) Q_DECL_OVERRIDE;
   
 protected:
   // non-property members:
@@ -667,6 +683,8 @@ public:
   
   // non-virtual methods:
   void replot();
+  void markDirty();
+  bool dirty() const { return mDirty; }
   
 protected:
   // property members:
@@ -679,10 +697,14 @@ protected:
   
   // non-property members:
   QWeakPointer<QCPAbstractPaintBuffer> mPaintBuffer;
+  bool mDirty;
   
   // non-virtual methods:
-  void draw(QCPPainter *painter);
-  void drawToPaintBuffer();
+  void draw(QCPPainter *painter, const QRect &clipRect=QRect());
+  void drawToPaintBuffer(const QRect &clipRect=QRect());
+  bool drawTiled(QCPPainter *painter);
+  void drawTile(uchar *bits, int bytesPerLine, const QRect &deviceRect, double devicePixelRatio, QPainter::RenderHints renderHints, QCPPainter::PainterModes modes);
+  static bool drawsPixmaps(const QCPAbstractPlottable *plottable);
   void addChild(QCPLayerable *layerable, bool prepend);
   void removeChild(QCPLayerable *layerable);
   
@@ -691,9 +713,29 @@ private:
   
   friend class QCustomPlot;
   friend class QCPLayerable;
+  friend class QCPLayerTileTask;
 };
 Q_DECLARE_METATYPE(QCPLayer::LayerMode)
 
+class QCPLayerTileTask : public QRunnable
+{
+public:
+  QCPLayerTileTask(QCPLayer *layer, uchar *bits, int bytesPerLine, const QRect &deviceRect, double devicePixelRatio, QPainter::RenderHints renderHints, QCPPainter::PainterModes modes);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QCPLayer *mLayer;
+  uchar *mBits;
+  int mBytesPerLine;
+  QRect mDeviceRect;
+  double mDevicePixelRatio;
+  QPainter::RenderHints mRenderHints;
+  QCPPainter::PainterModes mModes;
+};
+
 class QCP_LIB_DECL QCPLayerable : public QObject
 {
   Q_OBJECT
@@ -759,6 +801,7 @@ protected:
   void setParentLayerable(QCPLayerable* parentLayerable);
   bool moveToLayer(QCPLayer *layer, bool prepend);
   void applyAntialiasingHint(QCPPainter *painter, bool localAntialiased, QCP::AntialiasedElement overrideElement) const;
+  void markLayerDirty();
   
 private:
   Q_DISABLE_COPY(QCPLayerable)
@@ -1558,11 +1601,13 @@ public:
   TickStepStrategy tickStepStrategy() const { return mTickStepStrategy; }
   int tickCount() const { return mTickCount; }
   double tickOrigin() const { return mTickOrigin; }
+  bool cacheLabels() const { return mCacheLabels; }
   
   // setters:
   void setTickStepStrategy(TickStepStrategy strategy);
   void setTickCount(int count);
   void setTickOrigin(double origin);
+  void setCacheLabels(bool enabled);
   
   // introduced virtual methods:
   virtual void generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels);
@@ -1572,6 +1617,15 @@ protected:
   TickStepStrategy mTickStepStrategy;
   int mTickCount;
   double mTickOrigin;
+  bool mCacheLabels;
+  
+  // non-property members:
+  double mCachedTickStep, mCachedTickOrigin;
+  QLocale mCachedLocale;
+  QChar mCachedFormatChar;
+  int mCachedPrecision;
+  QVector<double> mCachedTicks, mCachedLabelTicks;
+  QVector<QString> mCachedLabels;
   
   // introduced virtual methods:
   virtual double getTickStep(const QCPRange &range);
@@ -1582,6 +1636,7 @@ protected:
   virtual QVector<QString> createLabelVector(const QVector<double> &ticks, const QLocale &locale, QChar formatChar, int precision);
   
   // non-virtual methods:
+  void clearTickCache();
   void trimTicks(const QCPRange &range, QVector<double> &ticks, bool keepOneOutlier) const;
   double pickClosest(double target, const QVector<double> &candidates) const;
   double getMantissa(double input, double *magnitude=0) const;
@@ -2114,6 +2169,7 @@ public:
   void rescale(bool onlyVisiblePlottables=false);
   double pixelToCoord(double value) const;
   double coordToPixel(double value) const;
+  void coordToPixel(const double *values, double *pixels, int count, int valueStride=1, int pixelStride=1) const;
   SelectablePart getPartAt(const QPointF &pos) const;
   QList<QCPAbstractPlottable*> plottables() const;
   QList<QCPGraph*> graphs() const;
@@ -2274,11 +2330,12 @@ protected:
     QFont baseFont, expFont;
   };
   QCustomPlot *mParentPlot;
-  QByteArray mLabelParameterHash; // to determine whether mLabelCache needs to be cleared due to changed parameters
-  QCache<QString, CachedLabel> mLabelCache;
+  QByteArray mLabelParameterHash; // prefix of this painter's keys in the shared label cache, identifies the parameters the labels were created with
   QRect mAxisSelectionBox, mTickLabelsSelectionBox, mLabelSelectionBox;
   
   virtual QByteArray generateLabelParameterHash() const;
+  QByteArray labelCacheKey(const QString &text) const;
+  static QCache<QByteArray, CachedLabel> &labelCache();
   
   virtual void placeTickLabel(QCPPainter *painter, double position, int distanceToAxis, const QString &text, QSize *tickLabelsSize);
   virtual void drawTickLabel(QCPPainter *painter, double x, double y, const TickLabelData &labelData) const;
@@ -2376,6 +2433,7 @@ public:
   void applyTo(QCPPainter *painter, const QPen &defaultPen) const;
   void drawShape(QCPPainter *painter, const QPointF &pos) const;
   void drawShape(QCPPainter *painter, double x, double y) const;
+  void drawShapes(QCPPainter *painter, const QVector<QPointF> &positions) const;
 
 protected:
   // property members:
@@ -2388,6 +2446,10 @@ protected:
   
   // non-property members:
   bool mPenDefined;
+  
+  // non-virtual methods:
+  bool canUseSprite(const QCPPainter *painter) const;
+  QImage sprite(const QCPPainter *painter, double devicePixelRatio) const;
 };
 Q_DECLARE_TYPEINFO(QCPScatterStyle, Q_MOVABLE_TYPE);
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCPScatterStyle::ScatterProperties)
@@ -2421,9 +2483,12 @@ public:
   int size() const { return mData.size()-mPreallocSize; }
   bool isEmpty() const { return size() == 0; }
   bool autoSqueeze() const { return mAutoSqueeze; }
+  int rollingCapacity() const { return mRollingCapacity; }
+  int revision() const { return mRevision; }
   
   // setters:
   void setAutoSqueeze(bool enabled);
+  void setRollingCapacity(int capacity);
   
   // non-virtual methods:
   void set(const QCPDataContainer<DataType> &data);
@@ -2441,8 +2506,8 @@ public:
   
   const_iterator constBegin() const { return mData.constBegin()+mPreallocSize; }
   const_iterator constEnd() const { return mData.constEnd(); }
-  iterator begin() { return mData.begin()+mPreallocSize; }
-  iterator end() { return mData.end(); }
+  iterator begin() { mKeyRangeCacheValid = mValueRangeCacheValid = false; ++mRevision; return dataBegin(); }
+  iterator end() { mKeyRangeCacheValid = mValueRangeCacheValid = false; ++mRevision; return dataEnd(); }
   const_iterator findBegin(double sortKey, bool expandedRange=true) const;
   const_iterator findEnd(double sortKey, bool expandedRange=true) const;
   const_iterator at(int index) const { return constBegin()+qBound(0, index, size()); }
@@ -2454,15 +2519,31 @@ public:
 protected:
   // property members:
   bool mAutoSqueeze;
+  int mRollingCapacity;
   
   // non-property memebers:
+  struct RangeCacheEntry
+  {
+    QCPRange range;
+    bool haveLower, haveUpper;
+  };
   QVector<DataType> mData;
   int mPreallocSize;
   int mPreallocIteration;
+  bool mKeyRangeCacheValid, mValueRangeCacheValid;
+  RangeCacheEntry mKeyRangeCache[3], mValueRangeCache[3]; // indexed by QCP::SignDomain
+  int mRevision; // incremented by every modification of the data, see revision()
   
   // non-virtual methods:
+  iterator dataBegin() { return mData.begin()+mPreallocSize; }
+  iterator dataEnd() { return mData.end(); }
   void preallocateGrow(int minimumPreallocSize);
   void performAutoSqueeze();
+  void enforceRollingCapacity();
+  void rebuildRangeCache();
+  void expandRangeCache(const DataType &data);
+  void checkRangeCacheRemoval(const_iterator begin, const_iterator end);
+  static void expandRangeCacheEntry(RangeCacheEntry &entry, double lower, double upper, QCP::SignDomain signDomain);
 };
 
 // include implementation in header since it is a class template:
@@ -2503,6 +2584,14 @@ protected:
   sort. Failing to do so can not be detected by the container efficiently and will cause both
   rendering artifacts and potential data loss.
 
+  The key and value ranges over all data points (\ref keyRange, \ref valueRange without key
+  restriction) are cached per sign domain. Adding data only expands the cached ranges, so they
+  stay valid in O(1) per added point. Removing data points invalidates them only if a removed point
+  was at a bound of the cached ranges, and any access through the non-const iterators invalidates
+  them unconditionally. The next range query then rescans the data once. This makes repeated axis
+  rescaling of growing data sets (e.g. \ref QCustomPlot::rescaleAxes after every added sample)
+  independent of the number of data points.
+
   Implementing one-dimensional plottables that make use of a \ref QCPDataContainer<T> is usually
   done by subclassing from \ref QCPAbstractPlottable1D "QCPAbstractPlottable1D<T>", which
   introduces an according \a mDataContainer member and some convenience methods.
@@ -2570,6 +2659,10 @@ protected:
   You can manipulate the data points in-place through the non-const iterators, but great care must
   be taken when manipulating the sort key of a data point, see \ref sort, or the detailed
   description of this class.
+
+  Since the data may be modified through the returned iterator, calling this method invalidates the
+  cached key and value ranges (see \ref keyRange, \ref valueRange). Prefer \ref constBegin for
+  read-only access.
 */
 
 /*! \fn QCPDataContainer::iterator QCPDataContainer<DataType>::end() const
@@ -2579,6 +2672,8 @@ protected:
   You can manipulate the data points in-place through the non-const iterators, but great care must
   be taken when manipulating the sort key of a data point, see \ref sort, or the detailed
   description of this class.
+
+  Like \ref begin, calling this method invalidates the cached key and value ranges.
 */
 
 /*! \fn QCPDataContainer::const_iterator QCPDataContainer<DataType>::at(int index) const
@@ -2597,6 +2692,22 @@ protected:
   begin index of the returned range is 0, and the end index is \ref size.
 */
 
+/*! \fn int QCPDataContainer<DataType>::rollingCapacity() const
+
+  Returns the maximum number of data points this container keeps, or 0 if the container is
+  unbounded.
+
+  \see setRollingCapacity
+*/
+
+/*! \fn int QCPDataContainer<DataType>::revision() const
+
+  Returns a number that changes whenever the data in this container is modified, i.e. by \ref set,
+  \ref add, the remove methods, \ref clear and \ref sort, as well as by accessing the non-const
+  iterators \ref begin and \ref end. Plottables use it to tell whether data they derived from the
+  container (e.g. a spatial index) is still up to date.
+*/
+
 /* end documentation of inline functions */
 
 /*!
@@ -2606,8 +2717,12 @@ protected:
 template <class DataType>
 QCPDataContainer<DataType>::QCPDataContainer() :
   mAutoSqueeze(true),
+  mRollingCapacity(0),
   mPreallocSize(0),
-  mPreallocIteration(0)
+  mPreallocIteration(0),
+  mKeyRangeCacheValid(false),
+  mValueRangeCacheValid(false),
+  mRevision(0)
 {
 }
 
@@ -2630,6 +2745,42 @@ void QCPDataContainer<DataType>::setAutoSqueeze(bool enabled)
   }
 }
 
+/*!
+  Limits the container to hold at most \a capacity data points. Whenever data is added and the
+  container would grow beyond \a capacity, the data points with the smallest (sort-)keys are
+  evicted. This turns the container into a rolling window, as needed for strip charts that only
+  display the most recent samples of a time-ordered signal. Set \a capacity to 0 (the default) to
+  disable the limit.
+
+  Evicted points are not erased but moved into the preallocation pool, the same way \ref
+  removeBefore does. As long as new points are appended with ascending keys, adding a point to a
+  full container is thus O(1): it only advances the begin of the valid data. Once the unused
+  front pool has grown as large as \a capacity, the remaining points are moved back to the front
+  of the storage in one step, which amortizes to a constant cost per added point. The storage is
+  reserved for twice the capacity, so a full container doesn't reallocate while rolling. Because
+  the valid data stays contiguous and sorted, iterators as well as \ref findBegin and \ref findEnd
+  work unchanged.
+
+  If the container currently holds more than \a capacity points, the oldest ones are evicted
+  immediately.
+
+  \see rollingCapacity
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::setRollingCapacity(int capacity)
+{
+  capacity = qMax(0, capacity);
+  if (mRollingCapacity == capacity)
+    return;
+  
+  mRollingCapacity = capacity;
+  if (mRollingCapacity > 0)
+  {
+    enforceRollingCapacity();
+    mData.reserve(mPreallocSize+2*mRollingCapacity);
+  }
+}
+
 /*! \overload
   
   Replaces the current data in this container with the provided \a data.
@@ -2658,8 +2809,12 @@ void QCPDataContainer<DataType>::set(const QVector<DataType> &data, bool already
   mData = data;
   mPreallocSize = 0;
   mPreallocIteration = 0;
+  mKeyRangeCacheValid = mValueRangeCacheValid = false;
+  ++mRevision;
   if (!alreadySorted)
     sort();
+  if (mRollingCapacity > 0)
+    enforceRollingCapacity();
 }
 
 /*! \overload
@@ -2682,14 +2837,19 @@ void QCPDataContainer<DataType>::add(const QCPDataContainer<DataType> &data)
     if (mPreallocSize < n)
       preallocateGrow(n);
     mPreallocSize -= n;
-    std::copy(data.constBegin(), data.constEnd(), begin());
+    std::copy(data.constBegin(), data.constEnd(), dataBegin());
   } else // don't need to prepend, so append and merge if necessary
   {
     mData.resize(mData.size()+n);
-    std::copy(data.constBegin(), data.constEnd(), end()-n);
+    std::copy(data.constBegin(), data.constEnd(), dataEnd()-n);
     if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
-      std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
+      std::inplace_merge(dataBegin(), dataEnd()-n, dataEnd(), qcpLessThanSortKey<DataType>);
   }
+  for (QCPDataContainer<DataType>::const_iterator it = data.constBegin(); it != data.constEnd(); ++it)
+    expandRangeCache(*it);
+  ++mRevision;
+  if (mRollingCapacity > 0)
+    enforceRollingCapacity();
 }
 
 /*!
@@ -2719,16 +2879,21 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
     if (mPreallocSize < n)
       preallocateGrow(n);
     mPreallocSize -= n;
-    std::copy(data.constBegin(), data.constEnd(), begin());
+    std::copy(data.constBegin(), data.constEnd(), dataBegin());
   } else // don't need to prepend, so append and then sort and merge if necessary
   {
     mData.resize(mData.size()+n);
-    std::copy(data.constBegin(), data.constEnd(), end()-n);
+    std::copy(data.constBegin(), data.constEnd(), dataEnd()-n);
     if (!alreadySorted) // sort appended subrange if it wasn't already sorted
-      std::sort(end()-n, end(), qcpLessThanSortKey<DataType>);
+      std::sort(dataEnd()-n, dataEnd(), qcpLessThanSortKey<DataType>);
     if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
-      std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
+      std::inplace_merge(dataBegin(), dataEnd()-n, dataEnd(), qcpLessThanSortKey<DataType>);
   }
+  for (typename QVector<DataType>::const_iterator it = data.constBegin(); it != data.constEnd(); ++it)
+    expandRangeCache(*it);
+  ++mRevision;
+  if (mRollingCapacity > 0)
+    enforceRollingCapacity();
 }
 
 /*! \overload
@@ -2740,6 +2905,9 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
 template <class DataType>
 void QCPDataContainer<DataType>::add(const DataType &data)
 {
+  if (mRollingCapacity > 0 && size() >= mRollingCapacity && !isEmpty() && qcpLessThanSortKey<DataType>(data, *constBegin())) // rolling container is full and new point would be the oldest, so it is evicted right away
+    return;
+  
   if (isEmpty() || !qcpLessThanSortKey<DataType>(data, *(constEnd()-1))) // quickly handle appends if new data key is greater or equal to existing ones
   {
     mData.append(data);
@@ -2748,12 +2916,16 @@ void QCPDataContainer<DataType>::add(const DataType &data)
     if (mPreallocSize < 1)
       preallocateGrow(1);
     --mPreallocSize;
-    *begin() = data;
+    *dataBegin() = data;
   } else // handle inserts, maintaining sorted keys
   {
-    QCPDataContainer<DataType>::iterator insertionPoint = std::lower_bound(begin(), end(), data, qcpLessThanSortKey<DataType>);
+    QCPDataContainer<DataType>::iterator insertionPoint = std::lower_bound(dataBegin(), dataEnd(), data, qcpLessThanSortKey<DataType>);
     mData.insert(insertionPoint, data);
   }
+  expandRangeCache(data);
+  ++mRevision;
+  if (mRollingCapacity > 0)
+    enforceRollingCapacity();
 }
 
 /*!
@@ -2764,8 +2936,10 @@ void QCPDataContainer<DataType>::add(const DataType &data)
 template <class DataType>
 void QCPDataContainer<DataType>::removeBefore(double sortKey)
 {
-  QCPDataContainer<DataType>::iterator it = begin();
-  QCPDataContainer<DataType>::iterator itEnd = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::iterator it = dataBegin();
+  QCPDataContainer<DataType>::iterator itEnd = std::lower_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  checkRangeCacheRemoval(it, itEnd);
+  ++mRevision;
   mPreallocSize += itEnd-it; // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it)
   if (mAutoSqueeze)
     performAutoSqueeze();
@@ -2779,8 +2953,10 @@ void QCPDataContainer<DataType>::removeBefore(double sortKey)
 template <class DataType>
 void QCPDataContainer<DataType>::removeAfter(double sortKey)
 {
-  QCPDataContainer<DataType>::iterator it = std::upper_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  QCPDataContainer<DataType>::iterator itEnd = end();
+  QCPDataContainer<DataType>::iterator it = std::upper_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::iterator itEnd = dataEnd();
+  checkRangeCacheRemoval(it, itEnd);
+  ++mRevision;
   mData.erase(it, itEnd); // typically adds it to the postallocated block
   if (mAutoSqueeze)
     performAutoSqueeze();
@@ -2799,8 +2975,10 @@ void QCPDataContainer<DataType>::remove(double sortKeyFrom, double sortKeyTo)
   if (sortKeyFrom >= sortKeyTo || isEmpty())
     return;
   
-  QCPDataContainer<DataType>::iterator it = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKeyFrom), qcpLessThanSortKey<DataType>);
-  QCPDataContainer<DataType>::iterator itEnd = std::upper_bound(it, end(), DataType::fromSortKey(sortKeyTo), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::iterator it = std::lower_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKeyFrom), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::iterator itEnd = std::upper_bound(it, dataEnd(), DataType::fromSortKey(sortKeyTo), qcpLessThanSortKey<DataType>);
+  checkRangeCacheRemoval(it, itEnd);
+  ++mRevision;
   mData.erase(it, itEnd);
   if (mAutoSqueeze)
     performAutoSqueeze();
@@ -2818,10 +2996,12 @@ void QCPDataContainer<DataType>::remove(double sortKeyFrom, double sortKeyTo)
 template <class DataType>
 void QCPDataContainer<DataType>::remove(double sortKey)
 {
-  QCPDataContainer::iterator it = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  if (it != end() && it->sortKey() == sortKey)
+  QCPDataContainer::iterator it = std::lower_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  if (it != dataEnd() && it->sortKey() == sortKey)
   {
-    if (it == begin())
+    checkRangeCacheRemoval(it, it+1);
+    ++mRevision;
+    if (it == dataBegin())
       ++mPreallocSize; // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it)
     else
       mData.erase(it);
@@ -2841,6 +3021,8 @@ void QCPDataContainer<DataType>::clear()
   mData.clear();
   mPreallocIteration = 0;
   mPreallocSize = 0;
+  rebuildRangeCache(); // resets the cached ranges to empty
+  ++mRevision;
 }
 
 /*!
@@ -2857,7 +3039,8 @@ void QCPDataContainer<DataType>::clear()
 template <class DataType>
 void QCPDataContainer<DataType>::sort()
 {
-  std::sort(begin(), end(), qcpLessThanSortKey<DataType>);
+  std::sort(dataBegin(), dataEnd(), qcpLessThanSortKey<DataType>);
+  ++mRevision;
 }
 
 /*!
@@ -2877,7 +3060,7 @@ void QCPDataContainer<DataType>::squeeze(bool preAllocation, bool postAllocation
   {
     if (mPreallocSize > 0)
     {
-      std::copy(begin(), end(), mData.begin());
+      std::copy(dataBegin(), dataEnd(), mData.begin());
       mData.resize(size());
       mPreallocSize = 0;
     }
@@ -2953,6 +3136,9 @@ typename QCPDataContainer<DataType>::const_iterator QCPDataContainer<DataType>::
   
   If the DataType reports that its main key is equal to the sort key (\a sortKeyIsMainKey), as is
   the case for most plottables, this method uses this fact and finds the range very quickly.
+  Otherwise, the range is taken from the running key ranges the container maintains while data is
+  added (see the detailed description of this class), so it is only rescanned after data at the
+  bounds was removed or modified.
   
   \see valueRange
 */
@@ -2964,103 +3150,45 @@ QCPRange QCPDataContainer<DataType>::keyRange(bool &foundRange, QCP::SignDomain
     foundRange = false;
     return QCPRange();
   }
-  QCPRange range;
-  bool haveLower = false;
-  bool haveUpper = false;
-  double current;
   
-  QCPDataContainer<DataType>::const_iterator it = constBegin();
-  QCPDataContainer<DataType>::const_iterator itEnd = constEnd();
-  if (signDomain == QCP::sdBoth) // range may be anywhere
-  {
-    if (DataType::sortKeyIsMainKey()) // if DataType is sorted by main key (e.g. QCPGraph, but not QCPCurve), use faster algorithm by finding just first and last key with non-NaN value
-    {
-      while (it != itEnd) // find first non-nan going up from left
-      {
-        if (!qIsNaN(it->mainValue()))
-        {
-          range.lower = it->mainKey();
-          haveLower = true;
-          break;
-        }
-        ++it;
-      }
-      it = itEnd;
-      while (it != constBegin()) // find first non-nan going down from right
-      {
-        --it;
-        if (!qIsNaN(it->mainValue()))
-        {
-          range.upper = it->mainKey();
-          haveUpper = true;
-          break;
-        }
-      }
-    } else // DataType is not sorted by main key, go through all data points and accordingly expand range
-    {
-      while (it != itEnd)
-      {
-        if (!qIsNaN(it->mainValue()))
-        {
-          current = it->mainKey();
-          if (current < range.lower || !haveLower)
-          {
-            range.lower = current;
-            haveLower = true;
-          }
-          if (current > range.upper || !haveUpper)
-          {
-            range.upper = current;
-            haveUpper = true;
-          }
-        }
-        ++it;
-      }
-    }
-  } else if (signDomain == QCP::sdNegative) // range may only be in the negative sign domain
+  if (signDomain == QCP::sdBoth && DataType::sortKeyIsMainKey()) // if DataType is sorted by main key (e.g. QCPGraph, but not QCPCurve), use faster algorithm by finding just first and last key with non-NaN value
   {
-    while (it != itEnd)
+    QCPRange range;
+    bool haveLower = false;
+    bool haveUpper = false;
+    QCPDataContainer<DataType>::const_iterator it = constBegin();
+    QCPDataContainer<DataType>::const_iterator itEnd = constEnd();
+    while (it != itEnd) // find first non-nan going up from left
     {
       if (!qIsNaN(it->mainValue()))
       {
-        current = it->mainKey();
-        if ((current < range.lower || !haveLower) && current < 0)
-        {
-          range.lower = current;
-          haveLower = true;
-        }
-        if ((current > range.upper || !haveUpper) && current < 0)
-        {
-          range.upper = current;
-          haveUpper = true;
-        }
+        range.lower = it->mainKey();
+        haveLower = true;
+        break;
       }
       ++it;
     }
-  } else if (signDomain == QCP::sdPositive) // range may only be in the positive sign domain
-  {
-    while (it != itEnd)
+    it = itEnd;
+    while (it != constBegin()) // find first non-nan going down from right
     {
+      --it;
       if (!qIsNaN(it->mainValue()))
       {
-        current = it->mainKey();
-        if ((current < range.lower || !haveLower) && current > 0)
-        {
-          range.lower = current;
-          haveLower = true;
-        }
-        if ((current > range.upper || !haveUpper) && current > 0)
-        {
-          range.upper = current;
-          haveUpper = true;
-        }
+        range.upper = it->mainKey();
+        haveUpper = true;
+        break;
       }
-      ++it;
     }
+    foundRange = haveLower && haveUpper;
+    return range;
   }
   
-  foundRange = haveLower && haveUpper;
-  return range;
+  // all other cases would need to go through all data points, so use the running ranges instead:
+  if (!mKeyRangeCacheValid)
+    rebuildRangeCache();
+  const RangeCacheEntry &entry = mKeyRangeCache[signDomain];
+  foundRange = entry.haveLower && entry.haveUpper;
+  return entry.range;
 }
 
 /*!
@@ -3077,6 +3205,10 @@ QCPRange QCPDataContainer<DataType>::keyRange(bool &foundRange, QCP::SignDomain
   relevant e.g. for logarithmic plots which can mathematically only display one sign domain at a
   time.
 
+  Without key restriction, the range is taken from the running value ranges the container maintains
+  while data is added (see the detailed description of this class), so this doesn't iterate over
+  the data points unless data at the bounds was removed or modified.
+
   \see keyRange
 */
 template <class DataType>
@@ -3087,8 +3219,17 @@ QCPRange QCPDataContainer<DataType>::valueRange(bool &foundRange, QCP::SignDomai
     foundRange = false;
     return QCPRange();
   }
-  QCPRange range;
   const bool restrictKeyRange = inKeyRange != QCPRange();
+  if (!restrictKeyRange)
+  {
+    if (!mValueRangeCacheValid)
+      rebuildRangeCache();
+    const RangeCacheEntry &entry = mValueRangeCache[signDomain];
+    foundRange = entry.haveLower && entry.haveUpper;
+    return entry.range;
+  }
+  
+  QCPRange range;
   bool haveLower = false;
   bool haveUpper = false;
   QCPRange current;
@@ -3236,6 +3377,139 @@ void QCPDataContainer<DataType>::performAutoSqueeze()
   if (shrinkPreAllocation || shrinkPostAllocation)
     squeeze(shrinkPreAllocation, shrinkPostAllocation);
 }
+
+/*! \internal
+
+  Evicts the data points with the smallest (sort-)keys until the container holds no more than \ref
+  rollingCapacity points. Evicted points are added to the preallocation pool, so this is O(1) per
+  call. When an eviction has grown the pool to the rolling capacity, the valid data is moved back to
+  the front of \a mData without releasing the reserved memory, which keeps the amortized cost per
+  added point constant and the storage bounded to about twice the capacity. Without an eviction,
+  the pool is left alone, so prepending to a container below its capacity doesn't compact on every
+  point.
+
+  \see setRollingCapacity
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::enforceRollingCapacity()
+{
+  const int excess = size()-mRollingCapacity;
+  if (excess <= 0)
+    return;
+  
+  checkRangeCacheRemoval(dataBegin(), dataBegin()+excess);
+  mPreallocSize += excess; // don't actually delete, just add it to the preallocated block, like removeBefore
+  ++mRevision;
+  if (mPreallocSize >= mRollingCapacity)
+  {
+    std::copy(dataBegin(), dataEnd(), mData.begin());
+    mData.resize(size()); // QVector keeps its capacity when shrinking, so following appends don't reallocate
+    mPreallocSize = 0;
+    mPreallocIteration = 0;
+  }
+}
+
+/*! \internal
+
+  Recomputes the cached key and value ranges of all sign domains in a single pass over the data,
+  and marks them as valid. This is called lazily by \ref keyRange and \ref valueRange when data at
+  the bounds of the cached ranges was removed or the data was modified through the non-const
+  iterators.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::rebuildRangeCache()
+{
+  for (int i=0; i<3; ++i)
+  {
+    mKeyRangeCache[i].range = QCPRange();
+    mKeyRangeCache[i].haveLower = mKeyRangeCache[i].haveUpper = false;
+    mValueRangeCache[i].range = QCPRange();
+    mValueRangeCache[i].haveLower = mValueRangeCache[i].haveUpper = false;
+  }
+  mKeyRangeCacheValid = true;
+  mValueRangeCacheValid = true;
+  for (QCPDataContainer<DataType>::const_iterator it = constBegin(); it != constEnd(); ++it)
+    expandRangeCache(*it);
+}
+
+/*! \internal
+
+  Expands the cached key and value ranges of all sign domains to include \a data, if they are
+  currently valid. Points with NaN value are ignored for the key ranges, like in \ref keyRange.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::expandRangeCache(const DataType &data)
+{
+  if (mKeyRangeCacheValid && !qIsNaN(data.mainValue()))
+  {
+    const double key = data.mainKey();
+    for (int i=0; i<3; ++i)
+      expandRangeCacheEntry(mKeyRangeCache[i], key, key, QCP::SignDomain(i));
+  }
+  if (mValueRangeCacheValid)
+  {
+    const QCPRange current = data.valueRange();
+    for (int i=0; i<3; ++i)
+      expandRangeCacheEntry(mValueRangeCache[i], current.lower, current.upper, QCP::SignDomain(i));
+  }
+}
+
+/*! \internal
+
+  Must be called with the data points between \a begin and \a end before they are removed. If any of
+  them lies at a bound of the cached key or value ranges, the respective cache is invalidated,
+  because the new bound can't be known without rescanning the data. Removing points from the
+  inside of the ranges keeps the caches valid.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::checkRangeCacheRemoval(const_iterator begin, const_iterator end)
+{
+  for (QCPDataContainer<DataType>::const_iterator it = begin; it != end && (mKeyRangeCacheValid || mValueRangeCacheValid); ++it)
+  {
+    if (mKeyRangeCacheValid && !qIsNaN(it->mainValue()))
+    {
+      const double key = it->mainKey();
+      for (int i=0; i<3; ++i)
+      {
+        if ((mKeyRangeCache[i].haveLower && key == mKeyRangeCache[i].range.lower) ||
+            (mKeyRangeCache[i].haveUpper && key == mKeyRangeCache[i].range.upper))
+          mKeyRangeCacheValid = false;
+      }
+    }
+    if (mValueRangeCacheValid)
+    {
+      const QCPRange current = it->valueRange();
+      for (int i=0; i<3; ++i)
+      {
+        if ((mValueRangeCache[i].haveLower && current.lower == mValueRangeCache[i].range.lower) ||
+            (mValueRangeCache[i].haveUpper && current.upper == mValueRangeCache[i].range.upper))
+          mValueRangeCacheValid = false;
+      }
+    }
+  }
+}
+
+/*! \internal
+
+  Expands the cached range \a entry to include \a lower and \a upper, each only if it is not NaN
+  and lies within \a signDomain.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::expandRangeCacheEntry(RangeCacheEntry &entry, double lower, double upper, QCP::SignDomain signDomain)
+{
+  if (!qIsNaN(lower) && (lower < entry.range.lower || !entry.haveLower) &&
+      (signDomain == QCP::sdBoth || (signDomain == QCP::sdNegative && lower < 0) || (signDomain == QCP::sdPositive && lower > 0)))
+  {
+    entry.range.lower = lower;
+    entry.haveLower = true;
+  }
+  if (!qIsNaN(upper) && (upper > entry.range.upper || !entry.haveUpper) &&
+      (signDomain == QCP::sdBoth || (signDomain == QCP::sdNegative && upper < 0) || (signDomain == QCP::sdPositive && upper > 0)))
+  {
+    entry.range.upper = upper;
+    entry.haveUpper = true;
+  }
+}
 /* end of 'src/datacontainer.cpp' */
 
 
@@ -3306,6 +3580,7 @@ class QCP_LIB_DECL QCPAbstractPlottable : public QCPLayerable
   Q_PROPERTY(QCP::SelectionType selectable READ selectable WRITE setSelectable NOTIFY selectableChanged)
   Q_PROPERTY(QCPDataSelection selection READ selection WRITE setSelection NOTIFY selectionChanged)
   Q_PROPERTY(QCPSelectionDecorator* selectionDecorator READ selectionDecorator WRITE setSelectionDecorator)
+  Q_PROPERTY(bool spatialIndex READ spatialIndex WRITE setSpatialIndex)
   /// \endcond
 public:
   QCPAbstractPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis);
@@ -3323,6 +3598,7 @@ public:
   bool selected() const { return !mSelection.isEmpty(); }
   QCPDataSelection selection() const { return mSelection; }
   QCPSelectionDecorator *selectionDecorator() const { return mSelectionDecorator; }
+  bool spatialIndex() const { return mSpatialIndex; }
   
   // setters:
   void setName(const QString &name);
@@ -3335,6 +3611,7 @@ public:
   Q_SLOT void setSelectable(QCP::SelectionType selectable);
   Q_SLOT void setSelection(QCPDataSelection selection);
   void setSelectionDecorator(QCPSelectionDecorator *decorator);
+  void setSpatialIndex(bool enabled);
 
   // introduced virtual methods:
   virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=0) const Q_DECL_OVERRIDE = 0; // actually introduced in QCPLayerable as non-pure, but we want to force reimplementation for plottables
@@ -3345,6 +3622,7 @@ public:
   // non-property methods:
   void coordsToPixels(double key, double value, double &x, double &y) const;
   const QPointF coordsToPixels(double key, double value) const;
+  void coordsToPixels(const double *keys, const double *values, int count, int stride, QPointF *pixels) const;
   void pixelsToCoords(double x, double y, double &key, double &value) const;
   void pixelsToCoords(const QPointF &pixelPos, double &key, double &value) const;
   void rescaleAxes(bool onlyEnlarge=false) const;
@@ -3370,6 +3648,7 @@ protected:
   QCP::SelectionType mSelectable;
   QCPDataSelection mSelection;
   QCPSelectionDecorator *mSelectionDecorator;
+  bool mSpatialIndex;
   
   // reimplemented virtual methods:
   virtual QRect clipRect() const Q_DECL_OVERRIDE;
@@ -3386,6 +3665,8 @@ protected:
   // non-virtual methods:
   void applyFillAntialiasingHint(QCPPainter *painter) const;
   void applyScattersAntialiasingHint(QCPPainter *painter) const;
+  int replotCount() const;
+  QCPRange keyPixelRange() const;
 
 private:
   Q_DISABLE_COPY(QCPAbstractPlottable)
@@ -3396,6 +3677,42 @@ private:
 };
 
 
+class QCP_LIB_DECL QCPPixelColumnIndex
+{
+public:
+  QCPPixelColumnIndex();
+  
+  // getters:
+  bool isEmpty() const { return mPoints.isEmpty(); }
+  bool isUpToDate(int replotCount, quintptr dataSource, int dataRevision) const { return mReplotCount == replotCount && mDataSource == dataSource && mDataRevision == dataRevision; }
+  const QVector<QPointF> &points() const { return mPoints; }
+  
+  // non-property methods:
+  void clear();
+  void build(const QVector<QPointF> &points, Qt::Orientation keyOrientation, const QCPRange &keyPixelRange, int firstIndex, int replotCount, quintptr dataSource, int dataRevision);
+  int nearestPoint(const QPointF &pos, double keyTolerance, double *distanceSqr) const;
+  double segmentDistanceSqr(const QPointF &pos, double keyTolerance, int step=1) const;
+  QCPDataSelection pointsInRect(const QRectF &rect) const;
+  
+protected:
+  // non-property members:
+  QVector<QPointF> mPoints;
+  QVector<int> mColumnStart; // index of the first point in each pixel column, with a trailing entry holding the point count
+  QVector<double> mCrossMin, mCrossMax; // pixel extent perpendicular to the key axis of the points in each column
+  Qt::Orientation mKeyOrientation;
+  double mDirection; // 1 if the key pixel coordinate increases along the points, -1 otherwise
+  double mColumnOrigin;
+  int mFirstIndex, mReplotCount;
+  quintptr mDataSource; // address of the data container the index was built from
+  int mDataRevision;
+  
+  // non-virtual methods:
+  double keyPixel(const QPointF &pixel) const { return mKeyOrientation == Qt::Horizontal ? pixel.x() : pixel.y(); }
+  double crossPixel(const QPointF &pixel) const { return mKeyOrientation == Qt::Horizontal ? pixel.y() : pixel.x(); }
+  int columnAt(double keyPixel) const;
+  void columnsInRange(double keyPixel1, double keyPixel2, int &firstColumn, int &lastColumn) const;
+};
+
 /* end of 'src/plottable.h' */
 
 
@@ -3587,6 +3904,51 @@ private:
 /* including file 'src/core.h', size 14886                                   */
 /* commit ce344b3f96a62e5f652585e55f1ae7c7883cd45b 2018-06-25 01:03:39 +0200 */
 
+class QCP_LIB_DECL QCPRenderSnapshot
+{
+public:
+  QCPRenderSnapshot();
+  
+  // getters:
+  QSize size() const { return mSize; }
+  bool isNull() const { return mSize.isEmpty(); }
+  
+  // non-property methods:
+  QImage toImage(double scale=1.0) const;
+  bool saveRastered(const QString &fileName, double scale, const char *format, int quality=-1, int resolution=96, QCP::ResolutionUnit resolutionUnit=QCP::ruDotsPerInch) const;
+  bool savePdf(const QString &fileName, const QString &pdfCreator=QString(), const QString &pdfTitle=QString()) const;
+  
+protected:
+  // non-property members:
+  QPicture mPicture;
+  QSize mSize;
+  
+  friend class QCustomPlot;
+};
+
+
+class QCP_LIB_DECL QCPSnapshotSaveTask : public QObject, public QRunnable
+{
+  Q_OBJECT
+public:
+  QCPSnapshotSaveTask(const QCPRenderSnapshot &snapshot, const QString &fileName, double scale, int quality, int resolution, QCP::ResolutionUnit resolutionUnit);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+signals:
+  void finished(const QString &fileName, bool success);
+  
+protected:
+  // non-property members:
+  QCPRenderSnapshot mSnapshot;
+  QString mFileName;
+  double mScale;
+  int mQuality, mResolution;
+  QCP::ResolutionUnit mResolutionUnit;
+};
+
+
 class QCP_LIB_DECL QCustomPlot : public QWidget
 {
   Q_OBJECT
@@ -3601,6 +3963,7 @@ class QCP_LIB_DECL QCustomPlot : public QWidget
   Q_PROPERTY(bool noAntialiasingOnDrag READ noAntialiasingOnDrag WRITE setNoAntialiasingOnDrag)
   Q_PROPERTY(Qt::KeyboardModifier multiSelectModifier READ multiSelectModifier WRITE setMultiSelectModifier)
   Q_PROPERTY(bool openGl READ openGl WRITE setOpenGl)
+  Q_PROPERTY(int exportResolution READ exportResolution WRITE setExportResolution)
   /// \endcond
 public:
   /*!
@@ -3646,6 +4009,8 @@ public:
   QCP::SelectionRectMode selectionRectMode() const { return mSelectionRectMode; }
   QCPSelectionRect *selectionRect() const { return mSelectionRect; }
   bool openGl() const { return mOpenGl; }
+  int exportResolution() const { return mExportResolution; }
+  QCPPlotGroup *plotGroup() const { return mPlotGroup; }
   
   // setters:
   void setViewport(const QRect &rect);
@@ -3670,6 +4035,7 @@ public:
   void setSelectionRectMode(QCP::SelectionRectMode mode);
   void setSelectionRect(QCPSelectionRect *selectionRect);
   void setOpenGl(bool enabled, int multisampling=16);
+  void setExportResolution(int dpi);
   
   // non-property methods:
   // plottable interface:
@@ -3734,6 +4100,8 @@ public:
   bool saveRastered(const QString &fileName, int width, int height, double scale, const char *format, int quality=-1, int resolution=96, QCP::ResolutionUnit resolutionUnit=QCP::ruDotsPerInch);
   QPixmap toPixmap(int width=0, int height=0, double scale=1.0);
   void toPainter(QCPPainter *painter, int width=0, int height=0);
+  QCPRenderSnapshot snapshot(int width=0, int height=0, QCP::ExportPen exportPen=QCP::epNoCosmetic);
+  void saveInBackground(const QString &fileName, int width=0, int height=0, double scale=1.0, int quality=-1, int resolution=96, QCP::ResolutionUnit resolutionUnit=QCP::ruDotsPerInch);
   Q_SLOT void replot(QCustomPlot::RefreshPriority refreshPriority=QCustomPlot::rpRefreshHint);
   
   QCPAxis *xAxis, *yAxis, *xAxis2, *yAxis2;
@@ -3758,6 +4126,7 @@ signals:
   void selectionChangedByUser();
   void beforeReplot();
   void afterReplot();
+  void backgroundSaveFinished(const QString &fileName, bool success);
   
 protected:
   // property members:
@@ -3784,6 +4153,7 @@ protected:
   QCP::SelectionRectMode mSelectionRectMode;
   QCPSelectionRect *mSelectionRect;
   bool mOpenGl;
+  int mExportResolution;
   
   // non-property members:
   QList<QSharedPointer<QCPAbstractPaintBuffer> > mPaintBuffers;
@@ -3795,9 +4165,17 @@ protected:
   QVariant mMouseSignalLayerableDetails;
   bool mReplotting;
   bool mReplotQueued;
+  bool mFullReplotRequested;
+  QVector<double> mReplotState;
+  QVector<double> mReplotStripChartZoom;
+  int mReplotCount; // incremented by every replot, allows plottables to rebuild lazily computed pixel data afterwards
+  QHash<QCPAxis*, double> mStripChartLowers;
+  QHash<QCPAxisRect*, double> mStripChartErrors;
+  QThreadPool mRasterThreadPool;
   int mOpenGlMultisamples;
   QCP::AntialiasedElements mOpenGlAntialiasedElementsBackup;
   bool mOpenGlCacheLabelsBackup;
+  QCPPlotGroup *mPlotGroup;
 #ifdef QCP_OPENGL_FBO
   QSharedPointer<QOpenGLContext> mGlContext;
   QSharedPointer<QSurface> mGlSurface;
@@ -3835,6 +4213,10 @@ protected:
   void setupPaintBuffers();
   QCPAbstractPaintBuffer *createPaintBuffer();
   bool hasInvalidatedPaintBuffers();
+  QVector<double> replotState(QVector<double> *stripChartZoom) const;
+  bool replotStateChanged(const QVector<double> &state, const QVector<double> &stripChartZoom) const;
+  void scrollStripCharts(QSet<QCPAbstractPaintBuffer*> &redrawBuffers, QHash<QCPAbstractPaintBuffer*, QRect> &exposedRects);
+  void updateStripChartLowers();
   bool setupOpenGl();
   void freeOpenGl();
   
@@ -3845,10 +4227,62 @@ protected:
   friend class QCPAbstractPlottable;
   friend class QCPGraph;
   friend class QCPAbstractItem;
+  friend class QCPPlotGroup;
 };
 Q_DECLARE_METATYPE(QCustomPlot::LayerInsertMode)
 Q_DECLARE_METATYPE(QCustomPlot::RefreshPriority)
 
+
+class QCP_LIB_DECL QCPPlotGroup : public QObject
+{
+  Q_OBJECT
+  /// \cond INCLUDE_QPROPERTIES
+  Q_PROPERTY(int frameInterval READ frameInterval WRITE setFrameInterval)
+  /// \endcond
+public:
+  explicit QCPPlotGroup(QObject *parent=0);
+  virtual ~QCPPlotGroup();
+  
+  // getters:
+  int frameInterval() const { return mFrameInterval; }
+  
+  // setters:
+  void setFrameInterval(int msec);
+  
+  // non-property methods:
+  QList<QCustomPlot*> plots() const;
+  bool hasPlot(QCustomPlot *plot) const;
+  bool addPlot(QCustomPlot *plot);
+  bool removePlot(QCustomPlot *plot);
+  QList<QCPAxis*> linkedAxes() const;
+  bool linkAxis(QCPAxis *axis);
+  bool unlinkAxis(QCPAxis *axis);
+  QCPGraph *addSharedGraph(QCustomPlot *plot, const QCPGraph *source, QCPAxis *keyAxis=0, QCPAxis *valueAxis=0);
+  void queueReplot(QCustomPlot *plot);
+  Q_SLOT void replot(QCustomPlot::RefreshPriority refreshPriority=QCustomPlot::rpQueuedReplot);
+  
+signals:
+  void beforeReplot();
+  void afterReplot();
+  
+protected:
+  // property members:
+  int mFrameInterval;
+  
+  // non-property members:
+  QList<QPointer<QCustomPlot> > mPlots;
+  QList<QPointer<QCPAxis> > mLinkedAxes;
+  QList<QPointer<QCustomPlot> > mPendingPlots;
+  QTimer mFrameTimer;
+  bool mSyncingRanges;
+  
+  // non-virtual methods:
+  Q_SLOT void processQueuedReplots();
+  Q_SLOT void linkedRangeChanged(const QCPRange &newRange);
+  
+  friend class QCustomPlot;
+};
+
 /* end of 'src/core.h' */
 
 
@@ -3901,9 +4335,13 @@ protected:
   // property members:
   QSharedPointer<QCPDataContainer<DataType> > mDataContainer;
   
+  // non-property members:
+  mutable QCPPixelColumnIndex mPointIndex;
+  
   // helpers for subclasses:
   void getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const;
   void drawPolyline(QCPPainter *painter, const QVector<QPointF> &lineData) const;
+  const QCPPixelColumnIndex &pointIndex() const;
 
 private:
   Q_DISABLE_COPY(QCPAbstractPlottable1D)
@@ -4216,6 +4654,9 @@ bool QCPAbstractPlottable1D<DataType>::sortKeyIsMainKey() const
   point-like. Most subclasses will want to reimplement this method again, to provide a more
   accurate hit test based on the true data visualization geometry.
 
+  If the spatial index is enabled (\ref setSpatialIndex) and the data is sorted by key, the test
+  is performed in pixel coordinates with the help of the index (see \ref pointIndex).
+
   \seebaseclassmethod
 */
 template <class DataType>
@@ -4227,6 +4668,9 @@ QCPDataSelection QCPAbstractPlottable1D<DataType>::selectTestRect(const QRectF &
   if (!mKeyAxis || !mValueAxis)
     return result;
   
+  if (mSpatialIndex && DataType::sortKeyIsMainKey())
+    return pointIndex().pointsInRect(rect);
+  
   // convert rect given in pixels to ranges given in plot coordinates:
   double key1, value1, key2, value2;
   pixelsToCoords(rect.topLeft(), key1, value1);
@@ -4290,6 +4734,9 @@ int QCPAbstractPlottable1D<DataType>::findEnd(double sortKey, bool expandedRange
   If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data point
   to \a pos.
   
+  If the spatial index is enabled (\ref setSpatialIndex), the data is sorted by key and \a pos
+  lies inside the axis rect, the closest point is looked up in the index (see \ref pointIndex).
+  
   \seebaseclassmethod
 */
 template <class DataType>
@@ -4304,6 +4751,16 @@ double QCPAbstractPlottable1D<DataType>::selectTest(const QPointF &pos, bool onl
   double minDistSqr = (std::numeric_limits<double>::max)();
   int minDistIndex = mDataContainer->size();
   
+  if (mSpatialIndex && DataType::sortKeyIsMainKey() && mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()))
+  {
+    const int index = pointIndex().nearestPoint(pos, mParentPlot->selectionTolerance(), &minDistSqr);
+    if (index >= 0)
+      selectionResult.addDataRange(QCPDataRange(index, index+1), false);
+    if (details)
+      details->setValue(selectionResult);
+    return qSqrt(minDistSqr);
+  }
+  
   typename QCPDataContainer<DataType>::const_iterator begin = mDataContainer->constBegin();
   typename QCPDataContainer<DataType>::const_iterator end = mDataContainer->constEnd();
   if (DataType::sortKeyIsMainKey()) // we can assume that data is sorted by main key, so can reduce the searched key interval:
@@ -4429,6 +4886,33 @@ void QCPAbstractPlottable1D<DataType>::drawPolyline(QCPPainter *painter, const Q
     painter->drawPolyline(lineData.constData()+segmentStart, lineDataSize-segmentStart);
   }
 }
+
+/*! \internal
+
+  Returns the spatial index of the visible data points in pixel coordinates (see \ref
+  setSpatialIndex). The index is rebuilt if the parent plot was replotted or the data was modified
+  (see \ref QCPDataContainer::revision) or replaced since it was last built.
+
+  This requires the data to be sorted by key, i.e. \ref sortKeyIsMainKey must be true.
+*/
+template <class DataType>
+const QCPPixelColumnIndex &QCPAbstractPlottable1D<DataType>::pointIndex() const
+{
+  const int currentReplotCount = replotCount();
+  const quintptr dataSource = reinterpret_cast<quintptr>(mDataContainer.data());
+  if (!mPointIndex.isUpToDate(currentReplotCount, dataSource, mDataContainer->revision()))
+  {
+    QCPAxis *keyAxis = mKeyAxis.data();
+    typename QCPDataContainer<DataType>::const_iterator begin = mDataContainer->findBegin(keyAxis->range().lower, true);
+    typename QCPDataContainer<DataType>::const_iterator end = mDataContainer->findEnd(keyAxis->range().upper, true);
+    QVector<QPointF> points(end-begin);
+    QPointF *pointData = points.data();
+    for (typename QCPDataContainer<DataType>::const_iterator it=begin; it!=end; ++it)
+      *pointData++ = coordsToPixels(it->mainKey(), it->mainValue());
+    mPointIndex.build(points, keyAxis->orientation(), keyPixelRange(), begin-mDataContainer->constBegin(), currentReplotCount, dataSource, mDataContainer->revision());
+  }
+  return mPointIndex;
+}
 /* end of 'src/plottable1d.cpp' */
 
 
@@ -4511,6 +4995,8 @@ protected:
   // non-virtual methods:
   bool stopsUseAlpha() const;
   void updateColorBuffer();
+  
+  friend class QCPColorMap;
 };
 Q_DECLARE_METATYPE(QCPColorGradient::ColorInterpolation)
 Q_DECLARE_METATYPE(QCPColorGradient::GradientPreset)
@@ -4599,6 +5085,7 @@ class QCP_LIB_DECL QCPAxisRect : public QCPLayoutElement
   Q_PROPERTY(Qt::AspectRatioMode backgroundScaledMode READ backgroundScaledMode WRITE setBackgroundScaledMode)
   Q_PROPERTY(Qt::Orientations rangeDrag READ rangeDrag WRITE setRangeDrag)
   Q_PROPERTY(Qt::Orientations rangeZoom READ rangeZoom WRITE setRangeZoom)
+  Q_PROPERTY(bool stripChart READ stripChart WRITE setStripChart)
   /// \endcond
 public:
   explicit QCPAxisRect(QCustomPlot *parentPlot, bool setupDefaultAxes=true);
@@ -4616,6 +5103,7 @@ public:
   QList<QCPAxis*> rangeDragAxes(Qt::Orientation orientation);
   QList<QCPAxis*> rangeZoomAxes(Qt::Orientation orientation);
   double rangeZoomFactor(Qt::Orientation orientation);
+  bool stripChart() const { return mStripChart; }
   
   // setters:
   void setBackground(const QPixmap &pm);
@@ -4633,6 +5121,7 @@ public:
   void setRangeZoomAxes(QList<QCPAxis*> horizontal, QList<QCPAxis*> vertical);
   void setRangeZoomFactor(double horizontalFactor, double verticalFactor);
   void setRangeZoomFactor(double factor);
+  void setStripChart(bool enabled);
   
   // non-property methods:
   int axisCount(QCPAxis::AxisType type) const;
@@ -4681,6 +5170,7 @@ protected:
   QList<QPointer<QCPAxis> > mRangeDragHorzAxis, mRangeDragVertAxis;
   QList<QPointer<QCPAxis> > mRangeZoomHorzAxis, mRangeZoomVertAxis;
   double mRangeZoomFactorHorz, mRangeZoomFactorVert;
+  bool mStripChart;
   
   // non-property members:
   QList<QCPRange> mDragStartHorzRange, mDragStartVertRange;
@@ -5169,6 +5659,9 @@ class QCP_LIB_DECL QCPGraph : public QCPAbstractPlottable1D<QCPGraphData>
   Q_PROPERTY(int scatterSkip READ scatterSkip WRITE setScatterSkip)
   Q_PROPERTY(QCPGraph* channelFillGraph READ channelFillGraph WRITE setChannelFillGraph)
   Q_PROPERTY(bool adaptiveSampling READ adaptiveSampling WRITE setAdaptiveSampling)
+  Q_PROPERTY(bool lodPyramid READ lodPyramid WRITE setLodPyramid)
+  Q_PROPERTY(bool batchedLines READ batchedLines WRITE setBatchedLines)
+  Q_PROPERTY(bool backgroundPreparation READ backgroundPreparation WRITE setBackgroundPreparation)
   /// \endcond
 public:
   /*!
@@ -5196,19 +5689,28 @@ public:
   int scatterSkip() const { return mScatterSkip; }
   QCPGraph *channelFillGraph() const { return mChannelFillGraph.data(); }
   bool adaptiveSampling() const { return mAdaptiveSampling; }
+  bool lodPyramid() const { return mLodPyramid; }
+  bool batchedLines() const { return mBatchedLines; }
+  bool backgroundPreparation() const { return mBackgroundPreparation; }
   
   // setters:
   void setData(QSharedPointer<QCPGraphDataContainer> data);
   void setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
+  void setData(const double *keys, const double *values, int count, bool alreadySorted=false);
   void setLineStyle(LineStyle ls);
   void setScatterStyle(const QCPScatterStyle &style);
   void setScatterSkip(int skip);
   void setChannelFillGraph(QCPGraph *targetGraph);
   void setAdaptiveSampling(bool enabled);
+  void setLodPyramid(bool enabled);
+  void setBatchedLines(bool enabled);
+  void setBackgroundPreparation(bool enabled);
   
   // non-property methods:
   void addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
+  void addData(const double *keys, const double *values, int count, bool alreadySorted=false);
   void addData(double key, double value);
+  void invalidateLodPyramid();
   
   // reimplemented virtual methods:
   virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=0) const Q_DECL_OVERRIDE;
@@ -5222,6 +5724,67 @@ protected:
   int mScatterSkip;
   QPointer<QCPGraph> mChannelFillGraph;
   bool mAdaptiveSampling;
+  bool mLodPyramid;
+  bool mBatchedLines;
+  bool mBackgroundPreparation;
+  
+  // non-property members:
+  struct AxisTransform // snapshot of the coordinate to pixel transform of an axis, usable on other threads
+  {
+    AxisTransform() : horizontal(true), logarithmic(false), reversed(false), origin(0), base(0), factor(0), lowerOutside(0), upperOutside(0) {}
+    bool horizontal, logarithmic, reversed;
+    QCPRange range;
+    QRect rect;
+    double origin, base, factor, lowerOutside, upperOutside;
+    static AxisTransform fromAxis(const QCPAxis *axis);
+    double coordToPixel(double value) const;
+    bool operator==(const AxisTransform &other) const { return horizontal == other.horizontal && logarithmic == other.logarithmic && reversed == other.reversed && range == other.range && rect == other.rect; }
+  };
+  struct PreparationState // everything the prepared pixel buffers depend on
+  {
+    PreparationState() : dataSource(0), dataRevision(-1), lineStyle(lsNone), scatters(false), scatterSkip(0), adaptiveSampling(false) {}
+    AxisTransform keyTransform, valueTransform;
+    quintptr dataSource;
+    int dataRevision; // see QCPDataContainer::revision
+    LineStyle lineStyle;
+    bool scatters;
+    int scatterSkip;
+    bool adaptiveSampling;
+    bool operator==(const PreparationState &other) const;
+  };
+  struct PreparedBuffers
+  {
+    PreparedBuffers() : valid(false) {}
+    bool valid;
+    PreparationState state;
+    QVector<QPointF> lines, scatters;
+  };
+  struct PreparationHandoff // shared with a running QCPGraphPreparationTask, guarded by mutex
+  {
+    PreparationHandoff() : graph(0), hasResult(false), running(false) {}
+    QMutex mutex;
+    QCPGraph *graph; // reset when the graph is deleted, so a finishing task doesn't notify it anymore
+    PreparedBuffers result;
+    bool hasResult, running;
+  };
+  PreparedBuffers mPreparedBuffers; // front buffer, only accessed on the GUI thread (QCPLayer::drawTiled doesn't tile layers with such graphs)
+  QSharedPointer<PreparationHandoff> mPreparationHandoff; // back buffer, filled by the preparation task
+  struct LodBucket
+  {
+    double firstKey, firstValue, lastKey, lastValue;
+    double minKey, minValue, maxKey, maxValue;
+    bool hasNan;
+  };
+  mutable QVector<QVector<LodBucket> > mLodLevels; // level n summarizes blocks of (mLodBaseBucketSize << n) consecutive data points
+  mutable QVector<int> mLodLevelOffsets; // block number of the first block kept in each level
+  mutable const QCPGraphDataContainer *mLodSource;
+  mutable int mLodPointCount;
+  mutable int mLodEvictedCount; // data points removed from the front since the pyramid was built, block numbers count from the first of those
+  mutable double mLodFirstKey, mLodLastKey;
+  mutable QMutex mLodMutex; // the pyramid is updated lazily while drawing, which may happen on several threads (see QCP::phTiledRaster)
+  static const int mLodBaseBucketSize = 16;
+  mutable QCPPixelColumnIndex mLineIndex;
+  static const int mLineBatchSize = 512; // points per polyline call of drawBatchedLines, 8 kB of QPointF stay in the first level cache
   
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
@@ -5239,7 +5802,17 @@ protected:
   // non-virtual methods:
   void getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin, QCPGraphDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const;
   void getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const;
+  void getExportLines(QVector<QPointF> *lines, const QCPDataRange &dataRange, double dotsPerPixel) const;
+  void getMinMaxDecimatedData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end, double dotsPerPixel) const;
+  static void appendDecimationBin(QVector<QCPGraphData> *lineData, QCPGraphDataContainer::const_iterator first, QCPGraphDataContainer::const_iterator minIt, QCPGraphDataContainer::const_iterator maxIt, QCPGraphDataContainer::const_iterator last);
+  static QVector<QPointF> decimatePolyline(const QVector<QPointF> &points, Qt::Orientation keyOrientation, double dotsPerPixel);
+  static QVector<QPointF> simplifyPolyline(const QVector<QPointF> &points, double tolerance);
+  PreparationState preparationState() const;
+  bool drawPreparedBuffers(QCPPainter *painter, const QCPDataRange &clipDataRange);
+  Q_SLOT void preparationFinished();
   void getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataRange) const;
+  void drawBatchedLines(QCPPainter *painter, const QVector<QPointF> &lines) const;
+  static bool clipLineSegment(QPointF &start, QPointF &end, const QRectF &rect);
   QVector<QPointF> dataToLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToStepLeftLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToStepRightLines(const QVector<QCPGraphData> &data) const;
@@ -5256,12 +5829,38 @@ protected:
   int findIndexBelowY(const QVector<QPointF> *data, double y) const;
   int findIndexAboveY(const QVector<QPointF> *data, double y) const;
   double pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer::const_iterator &closestData) const;
+  const QCPPixelColumnIndex &lineIndex() const;
+  void updateLodPyramid() const;
+  void evictLodPoints(int count) const;
+  bool getLodLineData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end, double keyPixelSpan) const;
+  void appendLodBucket(QVector<QCPGraphData> *lineData, int level, int index) const;
+  static LodBucket mergeLodBuckets(const LodBucket &a, const LodBucket &b);
   
   friend class QCustomPlot;
   friend class QCPLegend;
+  friend class QCPGraphPreparationTask;
 };
 Q_DECLARE_METATYPE(QCPGraph::LineStyle)
 
+
+class QCPGraphPreparationTask : public QRunnable
+{
+public:
+  QCPGraphPreparationTask(const QSharedPointer<QCPGraph::PreparationHandoff> &handoff, const QVector<QCPGraphData> &data, const QCPGraph::PreparationState &state);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QSharedPointer<QCPGraph::PreparationHandoff> mHandoff;
+  QVector<QCPGraphData> mData; // visible data points at the time the task was started
+  QCPGraph::PreparationState mState;
+  
+  // non-virtual methods:
+  QPointF toPixels(double key, double value) const;
+};
+
 /* end of 'src/plottables/plottable-graph.h' */
 
 
@@ -5307,6 +5906,7 @@ class QCP_LIB_DECL QCPCurve : public QCPAbstractPlottable1D<QCPCurveData>
   Q_PROPERTY(QCPScatterStyle scatterStyle READ scatterStyle WRITE setScatterStyle)
   Q_PROPERTY(int scatterSkip READ scatterSkip WRITE setScatterSkip)
   Q_PROPERTY(LineStyle lineStyle READ lineStyle WRITE setLineStyle)
+  Q_PROPERTY(bool streaming READ streaming WRITE setStreaming)
   /// \endcond
 public:
   /*!
@@ -5327,6 +5927,7 @@ public:
   QCPScatterStyle scatterStyle() const { return mScatterStyle; }
   int scatterSkip() const { return mScatterSkip; }
   LineStyle lineStyle() const { return mLineStyle; }
+  bool streaming() const { return mStreaming; }
   
   // setters:
   void setData(QSharedPointer<QCPCurveDataContainer> data);
@@ -5335,6 +5936,7 @@ public:
   void setScatterStyle(const QCPScatterStyle &style);
   void setScatterSkip(int skip);
   void setLineStyle(LineStyle style);
+  void setStreaming(bool enabled);
   
   // non-property methods:
   void addData(const QVector<double> &t, const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
@@ -5352,6 +5954,15 @@ protected:
   QCPScatterStyle mScatterStyle;
   int mScatterSkip;
   LineStyle mLineStyle;
+  bool mStreaming;
+  
+  // non-property members:
+  QVector<double> mStreamState; // axis ranges, axis rect and pen width that mStreamLines were computed for
+  const QCPCurveDataContainer *mStreamSource;
+  int mStreamCount; // number of data points already processed into mStreamLines
+  QCPCurveData mStreamFirst, mStreamLast; // first and last processed data point, to detect changes other than appending
+  int mStreamRegion; // clipping region of the last processed data point
+  QVector<QPointF> mStreamLines;
   
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
@@ -5363,6 +5974,7 @@ protected:
   
   // non-virtual methods:
   void getCurveLines(QVector<QPointF> *lines, const QCPDataRange &dataRange, double penWidth) const;
+  void getStreamingCurveLines(QVector<QPointF> *lines, double penWidth);
   void getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataRange, double scatterWidth) const;
   int getRegion(double key, double value, double keyMin, double valueMax, double keyMax, double valueMin) const;
   QPointF getOptimizedPoint(int prevRegion, double prevKey, double prevValue, double key, double value, double keyMin, double valueMax, double keyMax, double valueMin) const;
@@ -5726,6 +6338,8 @@ public:
   bool isEmpty() const { return mIsEmpty; }
   void coordToCell(double key, double value, int *keyIndex, int *valueIndex) const;
   void cellToCoord(int keyIndex, int valueIndex, double *key, double *value) const;
+  void appendColumn(const double *values);
+  void appendColumn(const QVector<double> &values);
   
 protected:
   // property members:
@@ -5737,9 +6351,15 @@ protected:
   double *mData;
   unsigned char *mAlpha;
   QCPRange mDataBounds;
+  int mKeyOffset; // physical key index of the cell with key index 0, advanced by appendColumn
   bool mDataModified;
+  int mModifiedKeyBegin, mModifiedKeyEnd; // range of physical key indices modified since the last map image update, only meaningful if mDataModified is true
+  int mModifiedValueBegin, mModifiedValueEnd; // range of value indices modified since the last map image update, only meaningful if mDataModified is true
   
   bool createAlpha(bool initializeOpaque=true);
+  void setAllModified();
+  void setRegionModified(int keyBegin, int keyEnd, int valueBegin, int valueEnd);
+  int physicalKeyIndex(int keyIndex) const { const int index = keyIndex+mKeyOffset; return index < mKeySize ? index : index-mKeySize; }
   
   friend class QCPColorMap;
 };
@@ -5804,6 +6424,7 @@ protected:
   
   // non-property members:
   QImage mMapImage, mUndersampledMapImage;
+  int mMapImageKeyOffset; // key offset of the map data at the time mMapImage was last updated
   QPixmap mLegendIcon;
   bool mMapImageInvalidated;
   
@@ -5814,8 +6435,31 @@ protected:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
   
+  // non-virtual methods:
+  void colorizeLines(uchar *bits, int bytesPerLine, int lineCount, int firstLine, int endLine, int firstCell, int endCell);
+  void drawMapImage(QPainter *painter, const QRectF &targetRect, bool mirrorX, bool mirrorY) const;
+  bool mapImageOutdated() const;
+  
   friend class QCustomPlot;
   friend class QCPLegend;
+  friend class QCPColorMapColorizeTask;
+};
+
+
+class QCPColorMapColorizeTask : public QRunnable
+{
+public:
+  QCPColorMapColorizeTask(QCPColorMap *colorMap, uchar *bits, int bytesPerLine, int lineCount, int firstLine, int endLine, int firstCell, int endCell, QSemaphore *done);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QCPColorMap *mColorMap;
+  uchar *mBits;
+  int mBytesPerLine, mLineCount, mFirstLine, mEndLine, mFirstCell, mEndCell;
+  QSemaphore *mDone;
 };
 
 /* end of 'src/plottables/plottable-colormap.h' */
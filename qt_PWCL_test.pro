@@ -52,12 +52,14 @@ SOURCES += \
         main.cpp \
         mainwindow.cpp \
         port.cpp \
+        runarchive.cpp \
         qcustomplot.cpp
 
 HEADERS += \
         about.h \
         mainwindow.h \
         port.h \
+        runarchive.h \
         qcustomplot.h
 
 FORMS += \
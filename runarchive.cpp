@@ -0,0 +1,157 @@
+/*
+Copyright (C) 2019  Anthony Arrowood
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "runarchive.h"
+#include <QDebug>
+
+using namespace QXlsx;
+
+static const QString summarySheetName = QStringLiteral("Summary");
+
+
+/**
+ * Opens the workbook 'fileName' if it exists (runs from earlier in the shift), otherwise starts a new one.
+ * Sheets of earlier runs are finalized right away so their cells are not kept in memory.
+ */
+RunArchive::RunArchive(const QString &fileName)
+    : fileName(fileName), doc(fileName), summary(nullptr), run(nullptr), runRow(1), summaryRow(1)
+{
+    if (!doc.sheetNames().contains(summarySheetName)) {
+        doc.addSheet(summarySheetName);
+        this->summary = static_cast<Worksheet*>(doc.sheet(summarySheetName));
+        this->summary->write(1, 1, "Run");
+        this->summary->write(1, 2, "Score");
+        this->summary->write(1, 3, "Average Error");
+        this->summary->write(1, 4, "Input Variance");
+    } else {
+        this->summary = static_cast<Worksheet*>(doc.sheet(summarySheetName));
+        this->summaryRow = this->summary->dimension().lastRow();
+    }
+    // the rounding precision is only kept in memory, so it has to be set again after reopening the workbook
+    this->summary->setColumnPrecision(2, 4, 2);
+
+    foreach (QString name, doc.sheetNames()) {
+        if (name != summarySheetName)
+            static_cast<Worksheet*>(doc.sheet(name))->finalize();
+    }
+}
+
+
+/**
+ * Adds a new sheet named 'runName' for the samples of the next run.
+ * Returns false if a run is already in progress or the name is taken.
+ */
+bool RunArchive::beginRun(const QString &runName)
+{
+    if (isRunning() || !doc.addSheet(runName))
+        return false;
+
+    this->run = static_cast<Worksheet*>(doc.sheet(doc.sheetNames().last()));
+    this->run->write(1, 1, "Time");
+    this->run->write(1, 2, "Percent On");
+    this->run->write(1, 3, "Temperature");
+    this->run->write(1, 4, "Filtered Temperature");
+    this->run->write(1, 5, "Set Point");
+    this->run->write(1, 6, "Fan Speed");
+    this->run->setColumnPrecision(1, 6, 2);
+    this->runRow = 1;
+    return true;
+}
+
+
+/**
+ * Appends one row of data to the sheet of the current run.
+ */
+void RunArchive::addSample(double time, double percentOn, double temp, double tempFilt, double setPoint, double fanSpeed)
+{
+    if (!isRunning())
+        return;
+
+    this->runRow++;
+    this->run->write(this->runRow, 1, time);
+    this->run->write(this->runRow, 2, percentOn);
+    this->run->write(this->runRow, 3, temp);
+    this->run->write(this->runRow, 4, tempFilt);
+    this->run->write(this->runRow, 5, setPoint);
+    this->run->write(this->runRow, 6, fanSpeed);
+}
+
+
+/**
+ * Records the scores of the current run in the summary sheet and finalizes the run's sheet,
+ * which releases its cells. Only the summary sheet and the next run stay editable.
+ */
+void RunArchive::endRun(double score, double avgErr, double inputVar)
+{
+    if (!isRunning())
+        return;
+
+    this->summaryRow++;
+    this->summary->write(this->summaryRow, 1, this->run->sheetName());
+    this->summary->write(this->summaryRow, 2, score);
+    this->summary->write(this->summaryRow, 3, avgErr);
+    this->summary->write(this->summaryRow, 4, inputVar);
+
+    this->run->finalize();
+    this->run = nullptr;
+}
+
+
+bool RunArchive::isRunning() const
+{
+    return this->run != nullptr;
+}
+
+
+/**
+ * Returns the number of samples added to the current run, or 0 if no run is in progress.
+ */
+int RunArchive::sampleCount() const
+{
+    return isRunning() ? this->runRow - 1 : 0;
+}
+
+
+/**
+ * Copies the header and the samples of the current run into the current sheet of 'target',
+ * so a single run can be exported without keeping a second copy of it around while logging.
+ */
+void RunArchive::exportRun(QXlsx::Document &target) const
+{
+    if (!isRunning())
+        return;
+
+    for (int row = 1; row <= this->runRow; row++) {
+        for (int col = 1; col <= 6; col++)
+            target.write(row, col, this->run->read(row, col));
+    }
+}
+
+
+/**
+ * Writes the workbook. Finalized runs reuse the xml made when they ended,
+ * so only the summary and the current run are serialized again.
+ */
+bool RunArchive::save()
+{
+    if (!doc.saveAs(this->fileName)) {
+        qDebug() << " Failed to save run archive " << this->fileName << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2019  Anthony Arrowood
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef RUNARCHIVE_H
+#define RUNARCHIVE_H
+
+#include <QString>
+
+#include "xlsxdocument.h"
+#include "xlsxworksheet.h"
+
+
+/**
+ * Keeps every run of a shift in one excel workbook, a sheet per run plus a summary sheet of scores.
+ * When a run ends its sheet is finalized, so only the sheet's xml is kept in memory and
+ * the workbook can hold many runs without keeping all of their cells around.
+ */
+class RunArchive
+{
+public:
+    explicit RunArchive(const QString &fileName);
+    bool beginRun(const QString &runName);
+    void addSample(double time, double percentOn, double temp, double tempFilt, double setPoint, double fanSpeed);
+    void endRun(double score, double avgErr, double inputVar);
+    bool isRunning() const;
+    int sampleCount() const;
+    void exportRun(QXlsx::Document &target) const;
+    bool save();
+
+private:
+    QString fileName;
+    QXlsx::Document doc;
+    QXlsx::Worksheet* summary;
+    QXlsx::Worksheet* run;
+    int runRow;
+    int summaryRow;
+};
+
+#endif // RUNARCHIVE_H
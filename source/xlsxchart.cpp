@@ -12,6 +12,7 @@
 #include <QXmlStreamWriter>
 #include <QDebug>
 #include <QString>
+#include <QColor>
 
 QT_BEGIN_NAMESPACE_XLSX
 
@@ -138,6 +139,89 @@ void Chart::addSeries(const CellRange &range, AbstractSheet *sheet)
     }
 }
 
+/*!
+ * Add a data series whose keys are in \a keyRange and values are in
+ * \a valueRange of the \a sheet, both single rows or columns of the same
+ * length. The series is titled \a name and, for scatter charts, is plotted
+ * against a right-hand value axis when \a secondaryAxis is true.
+ *
+ * Only references to the ranges are stored, the cells are not read.
+ */
+void Chart::addSeries(const CellRange &keyRange, const CellRange &valueRange, AbstractSheet *sheet,
+                      const QString &name, bool secondaryAxis)
+{
+    Q_D(Chart);
+    if (!keyRange.isValid() || !valueRange.isValid())
+        return;
+    if (sheet && sheet->sheetType() != AbstractSheet::ST_WorkSheet)
+        return;
+    if (!sheet && d->sheet->sheetType() != AbstractSheet::ST_WorkSheet)
+        return;
+
+    QString sheetName = sheet ? sheet->sheetName() : d->sheet->sheetName();
+    //In case sheetName contains space or '
+    sheetName = escapeSheetName(sheetName);
+
+    QSharedPointer<XlsxSeries> series = QSharedPointer<XlsxSeries>(new XlsxSeries);
+    series->axDataSource_numRef = sheetName + QLatin1String("!") + keyRange.toString(true, true);
+    series->numberDataSource_numRef = sheetName + QLatin1String("!") + valueRange.toString(true, true);
+    series->name = name;
+    series->secondaryAxis = secondaryAxis;
+    d->seriesList.append(series);
+}
+
+/*!
+ * Returns the number of data series in the chart.
+ */
+int Chart::seriesCount() const
+{
+    Q_D(const Chart);
+    return d->seriesList.size();
+}
+
+/*!
+ * Removes all data series, so the chart can be rebuilt with new ranges.
+ */
+void Chart::clearSeries()
+{
+    Q_D(Chart);
+    d->seriesList.clear();
+    d->axisList.clear();
+}
+
+/*!
+ * Sets the line and marker color of the series at \a index to \a color.
+ */
+void Chart::setSeriesColor(int index, const QColor &color)
+{
+    Q_D(Chart);
+    if (index < 0 || index >= d->seriesList.size())
+        return;
+    d->seriesList[index]->color = color;
+}
+
+/*!
+ * Shows or hides the line connecting the points of the series at \a index.
+ */
+void Chart::setSeriesLineVisible(int index, bool visible)
+{
+    Q_D(Chart);
+    if (index < 0 || index >= d->seriesList.size())
+        return;
+    d->seriesList[index]->lineVisible = visible;
+}
+
+/*!
+ * Shows or hides the point markers of the series at \a index.
+ */
+void Chart::setSeriesMarkerVisible(int index, bool visible)
+{
+    Q_D(Chart);
+    if (index < 0 || index >= d->seriesList.size())
+        return;
+    d->seriesList[index]->markerVisible = visible;
+}
+
 /*!
  * Set the type of the chart to \a type
  */
@@ -477,25 +561,53 @@ void ChartPrivate::saveXmlLineChart(QXmlStreamWriter &writer) const
 }
 
 void ChartPrivate::saveXmlScatterChart(QXmlStreamWriter &writer) const
+{
+    bool hasSecondary = false;
+    for (int i=0; i<seriesList.size(); ++i)
+        hasSecondary |= seriesList[i]->secondaryAxis;
+
+    if (axisList.isEmpty())
+    {
+        const_cast<ChartPrivate*>(this)->axisList.append(QSharedPointer<XlsxAxis>(new XlsxAxis(XlsxAxis::T_Val, XlsxAxis::Bottom, 0, 1, axisNames[XlsxAxis::Bottom] )));
+        const_cast<ChartPrivate*>(this)->axisList.append(QSharedPointer<XlsxAxis>(new XlsxAxis(XlsxAxis::T_Val, XlsxAxis::Left, 1, 0, axisNames[XlsxAxis::Left] )));
+        if (hasSecondary)
+        {
+            //Secondary series get their own chart group: a hidden key axis and a right value axis
+            QSharedPointer<XlsxAxis> keyAxis(new XlsxAxis(XlsxAxis::T_Val, XlsxAxis::Bottom, 2, 3));
+            keyAxis->deleted = true;
+            QSharedPointer<XlsxAxis> valueAxis(new XlsxAxis(XlsxAxis::T_Val, XlsxAxis::Right, 3, 2, axisNames[XlsxAxis::Right] ));
+            valueAxis->crossesMax = true;
+            const_cast<ChartPrivate*>(this)->axisList.append(keyAxis);
+            const_cast<ChartPrivate*>(this)->axisList.append(valueAxis);
+        }
+    }
+
+    Q_ASSERT(axisList.size()==2 || axisList.size()==4);
+
+    saveXmlScatterChartGroup(writer, false);
+    if (axisList.size() == 4)
+        saveXmlScatterChartGroup(writer, true);
+}
+
+void ChartPrivate::saveXmlScatterChartGroup(QXmlStreamWriter &writer, bool secondary) const
 {
     const QString name = QStringLiteral("c:scatterChart");
 
     writer.writeStartElement(name);
 
     writer.writeEmptyElement(QStringLiteral("c:scatterStyle"));
+    writer.writeAttribute(QStringLiteral("val"), QStringLiteral("lineMarker"));
 
+    //Without a second axis pair every series goes into the primary group
+    const bool splitGroups = axisList.size() == 4;
     for (int i=0; i<seriesList.size(); ++i)
-        saveXmlSer(writer, seriesList[i].data(), i);
-
-    if (axisList.isEmpty())
     {
-        const_cast<ChartPrivate*>(this)->axisList.append(QSharedPointer<XlsxAxis>(new XlsxAxis(XlsxAxis::T_Val, XlsxAxis::Bottom, 0, 1, axisNames[XlsxAxis::Bottom] )));
-        const_cast<ChartPrivate*>(this)->axisList.append(QSharedPointer<XlsxAxis>(new XlsxAxis(XlsxAxis::T_Val, XlsxAxis::Left, 1, 0, axisNames[XlsxAxis::Left] )));
+        if (!splitGroups || seriesList[i]->secondaryAxis == secondary)
+            saveXmlSer(writer, seriesList[i].data(), i);
     }
 
-    Q_ASSERT(axisList.size()==2);
-
-    for (int i=0; i<axisList.size(); ++i)
+    const int firstAxis = secondary ? 2 : 0;
+    for (int i=firstAxis; i<firstAxis+2; ++i)
     {
         writer.writeEmptyElement(QStringLiteral("c:axId"));
         writer.writeAttribute(QStringLiteral("val"), QString::number(axisList[i]->axisId));
@@ -559,6 +671,50 @@ void ChartPrivate::saveXmlSer(QXmlStreamWriter &writer, XlsxSeries *ser, int id)
     writer.writeEmptyElement(QStringLiteral("c:order"));
     writer.writeAttribute(QStringLiteral("val"), QString::number(id));
 
+    if (!ser->name.isEmpty()) {
+        writer.writeStartElement(QStringLiteral("c:tx"));
+        writer.writeTextElement(QStringLiteral("c:v"), ser->name);
+        writer.writeEndElement();//c:tx
+    }
+
+    const QString colorHex = ser->color.isValid() ? ser->color.name().mid(1).toUpper() : QString();
+    if (!colorHex.isEmpty() || !ser->lineVisible) {
+        writer.writeStartElement(QStringLiteral("c:spPr"));
+        writer.writeStartElement(QStringLiteral("a:ln"));
+        if (!ser->lineVisible) {
+            writer.writeEmptyElement(QStringLiteral("a:noFill"));
+        } else {
+            writer.writeStartElement(QStringLiteral("a:solidFill"));
+            writer.writeEmptyElement(QStringLiteral("a:srgbClr"));
+            writer.writeAttribute(QStringLiteral("val"), colorHex);
+            writer.writeEndElement();//a:solidFill
+        }
+        writer.writeEndElement();//a:ln
+        writer.writeEndElement();//c:spPr
+    }
+
+    if ((chartType == Chart::CT_Scatter || chartType == Chart::CT_Line)
+            && (!ser->markerVisible || !colorHex.isEmpty())) {
+        writer.writeStartElement(QStringLiteral("c:marker"));
+        if (!ser->markerVisible) {
+            writer.writeEmptyElement(QStringLiteral("c:symbol"));
+            writer.writeAttribute(QStringLiteral("val"), QStringLiteral("none"));
+        } else {
+            writer.writeEmptyElement(QStringLiteral("c:symbol"));
+            writer.writeAttribute(QStringLiteral("val"), QStringLiteral("circle"));
+            writer.writeStartElement(QStringLiteral("c:spPr"));
+            writer.writeStartElement(QStringLiteral("a:solidFill"));
+            writer.writeEmptyElement(QStringLiteral("a:srgbClr"));
+            writer.writeAttribute(QStringLiteral("val"), colorHex);
+            writer.writeEndElement();//a:solidFill
+            writer.writeStartElement(QStringLiteral("a:ln"));
+            writer.writeEmptyElement(QStringLiteral("a:noFill"));
+            writer.writeEndElement();//a:ln
+            writer.writeEndElement();//c:spPr
+        }
+        writer.writeEndElement();//c:marker
+    }
+
     if (!ser->axDataSource_numRef.isEmpty()) {
         if (chartType == Chart::CT_Scatter || chartType == Chart::CT_Bubble)
             writer.writeStartElement(QStringLiteral("c:xVal"));
@@ -677,6 +833,23 @@ void ChartPrivate::saveXmlAxes(QXmlStreamWriter &writer) const
 
         writer.writeStartElement(name);
 
+        writer.writeEmptyElement(QStringLiteral("c:axId"));
+        writer.writeAttribute(QStringLiteral("val"), QString::number(axis->axisId));
+
+        writer.writeStartElement(QStringLiteral("c:scaling"));
+        writer.writeEmptyElement(QStringLiteral("c:orientation"));
+        writer.writeAttribute(QStringLiteral("val"), QStringLiteral("minMax"));
+        writer.writeEndElement();//c:scaling
+
+        if (axis->deleted)
+        {
+            writer.writeEmptyElement(QStringLiteral("c:delete"));
+            writer.writeAttribute(QStringLiteral("val"), QStringLiteral("1"));
+        }
+
+        writer.writeEmptyElement(QStringLiteral("c:axPos"));
+        writer.writeAttribute(QStringLiteral("val"), pos);
+
         // dev22 {{
 
         QString strAxisName;
@@ -725,20 +898,15 @@ void ChartPrivate::saveXmlAxes(QXmlStreamWriter &writer) const
         }
         // }} dev22
 
-        writer.writeEmptyElement(QStringLiteral("c:axId"));
-        writer.writeAttribute(QStringLiteral("val"), QString::number(axis->axisId));
-
-        writer.writeStartElement(QStringLiteral("c:scaling"));
-        writer.writeEmptyElement(QStringLiteral("c:orientation"));
-        writer.writeAttribute(QStringLiteral("val"), QStringLiteral("minMax"));
-        writer.writeEndElement();//c:scaling
-
-        writer.writeEmptyElement(QStringLiteral("c:axPos"));
-        writer.writeAttribute(QStringLiteral("val"), pos);
-
         writer.writeEmptyElement(QStringLiteral("c:crossAx"));
         writer.writeAttribute(QStringLiteral("val"), QString::number(axis->crossAx));
 
+        if (axis->crossesMax)
+        {
+            writer.writeEmptyElement(QStringLiteral("c:crosses"));
+            writer.writeAttribute(QStringLiteral("val"), QStringLiteral("max"));
+        }
+
         writer.writeEndElement();//name
     }
 }
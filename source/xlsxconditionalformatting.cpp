@@ -36,12 +36,13 @@
 QT_BEGIN_NAMESPACE_XLSX
 
 ConditionalFormattingPrivate::ConditionalFormattingPrivate()
+    :evaluatedOnSave(false)
 {
 
 }
 
 ConditionalFormattingPrivate::ConditionalFormattingPrivate(const ConditionalFormattingPrivate &other)
-    :QSharedData(other)
+    :QSharedData(other), cfRules(other.cfRules), ranges(other.ranges), evaluatedOnSave(other.evaluatedOnSave)
 {
 
 }
@@ -51,6 +52,64 @@ ConditionalFormattingPrivate::~ConditionalFormattingPrivate()
 
 }
 
+/*
+ * Evaluate a "cellIs" \a rule whose formulas are plain numbers for a cell
+ * holding \a value. Returns false if the rule needs Excel to evaluate it,
+ * otherwise stores whether the rule applies in \a matched.
+ */
+bool ConditionalFormattingPrivate::evaluateStaticRule(const XlsxCfRuleData &rule, double value, bool *matched)
+{
+    *matched = false;
+    if (rule.attrs.value(XlsxCfRuleData::A_type).toString() != QLatin1String("cellIs"))
+        return false;
+
+    const QString op = rule.attrs.value(XlsxCfRuleData::A_operator).toString();
+    const bool isRange = op == QLatin1String("between") || op == QLatin1String("notBetween");
+
+    bool ok1 = false;
+    bool ok2 = true;
+    const double v1 = rule.attrs.value(XlsxCfRuleData::A_formula1).toString().toDouble(&ok1);
+    const double v2 = isRange ? rule.attrs.value(XlsxCfRuleData::A_formula2).toString().toDouble(&ok2) : 0;
+    if (!ok1 || !ok2)
+        return false;
+
+    if (op == QLatin1String("lessThan"))
+        *matched = value < v1;
+    else if (op == QLatin1String("lessThanOrEqual"))
+        *matched = value <= v1;
+    else if (op == QLatin1String("equal"))
+        *matched = value == v1;
+    else if (op == QLatin1String("notEqual"))
+        *matched = value != v1;
+    else if (op == QLatin1String("greaterThanOrEqual"))
+        *matched = value >= v1;
+    else if (op == QLatin1String("greaterThan"))
+        *matched = value > v1;
+    else if (isRange) {
+        const bool inside = value >= qMin(v1, v2) && value <= qMax(v1, v2);
+        *matched = op == QLatin1String("between") ? inside : !inside;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Returns the rule indexes sorted by priority. Rules of the same priority
+ * keep the order they were added in.
+ */
+QList<int> ConditionalFormattingPrivate::priorityOrder() const
+{
+    QList<int> order;
+    for (int i=0; i<cfRules.size(); ++i) {
+        int pos = order.size();
+        while (pos > 0 && cfRules[order[pos-1]]->priority > cfRules[i]->priority)
+            --pos;
+        order.insert(pos, i);
+    }
+    return order;
+}
+
 void ConditionalFormattingPrivate::writeCfVo(QXmlStreamWriter &writer, const XlsxCfVoData &cfvo) const
 {
     writer.writeEmptyElement(QStringLiteral("cfvo"));
@@ -416,6 +475,87 @@ QList<CellRange> ConditionalFormatting::ranges() const
     return d->ranges;
 }
 
+/*!
+    When \a enable is true and every rule compares cell values against
+    plain numbers (e.g. Highlight_GreaterThan with "30"), the rules are
+    evaluated while the sheet is saved and matching cells get the rule
+    formats merged into their own style. The formatting is then not written
+    to the file, so large ranges open without Excel re-evaluating them.
+    Rules are applied in priority order and stopIfTrue is honoured; where
+    formats conflict, the higher priority rule wins.
+
+    If any rule needs Excel to evaluate it, or any cell of the ranges holds
+    a formula, the whole formatting is saved as usual instead.
+
+    \note Baked formats do not follow later edits of the cells in Excel.
+ */
+void ConditionalFormatting::setEvaluatedOnSave(bool enable)
+{
+    d->evaluatedOnSave = enable;
+}
+
+/*!
+    Returns whether numeric highlight rules are baked into cell styles on save.
+ */
+bool ConditionalFormatting::isEvaluatedOnSave() const
+{
+    return d->evaluatedOnSave;
+}
+
+/*!
+ * \internal
+ * Returns the rules that apply to the cell (\a row, \a col) holding \a value
+ * as a bit mask of rule indexes, or 0 if none does. Rules are checked in
+ * priority order, and checking stops at a matching stopIfTrue rule.
+ * Only meaningful if isStatic() returns true.
+ */
+quint64 ConditionalFormatting::matchStaticRules(int row, int col, double value) const
+{
+    if (!d->evaluatedOnSave)
+        return 0;
+
+    bool inRange = false;
+    foreach (const CellRange &range, d->ranges) {
+        if (row >= range.firstRow() && row <= range.lastRow()
+                && col >= range.firstColumn() && col <= range.lastColumn()) {
+            inRange = true;
+            break;
+        }
+    }
+    if (!inRange)
+        return 0;
+
+    quint64 rules = 0;
+    const QList<int> order = d->priorityOrder();
+    foreach (int i, order) {
+        bool matched;
+        if (ConditionalFormattingPrivate::evaluateStaticRule(*d->cfRules[i], value, &matched) && matched) {
+            rules |= quint64(1) << i;
+            if (d->cfRules[i]->attrs.value(XlsxCfRuleData::A_stopIfTrue).toBool())
+                break;
+        }
+    }
+    return rules;
+}
+
+/*!
+ * \internal
+ * Returns true if the formatting is evaluated on save and every rule can be
+ * evaluated without Excel, so that all of them can be baked into cell styles.
+ */
+bool ConditionalFormatting::isStatic() const
+{
+    if (!d->evaluatedOnSave || d->cfRules.isEmpty() || d->cfRules.size() > 64)
+        return false;
+
+    for (int i=0; i<d->cfRules.size(); ++i) {
+        bool matched;
+        if (!ConditionalFormattingPrivate::evaluateStaticRule(*d->cfRules[i], 0, &matched))
+            return false;
+    }
+    return true;
+}
+
 /*!
     Add the \a cell on which the conditional formatting will apply to.
  */
@@ -619,6 +619,41 @@ bool Document::setColumnHidden(int colFirst, int colLast, bool hidden)
 	return false;
 }
 
+/*!
+  Stores numeric values of columns [\a colFirst, \a colLast] with at most
+  \a decimals digits after the decimal point and a matching number format.
+  Columns are 1-indexed.
+  Returns true on success.
+ */
+bool Document::setColumnPrecision(int colFirst, int colLast, int decimals)
+{
+	if (Worksheet *sheet = currentWorksheet())
+		return sheet->setColumnPrecision(colFirst, colLast, decimals);
+	return false;
+}
+
+/*!
+  Stores numeric values of \a column with at most \a decimals digits
+  after the decimal point. Columns are 1-indexed.
+  Returns true on success.
+ */
+bool Document::setColumnPrecision(int column, int decimals)
+{
+	return setColumnPrecision(column, column, decimals);
+}
+
+/*!
+  Stores numeric values of the columns in \a range with at most
+  \a decimals digits after the decimal point.
+  Returns true on success.
+ */
+bool Document::setColumnPrecision(const CellRange &range, int decimals)
+{
+	if (Worksheet *sheet = currentWorksheet())
+		return sheet->setColumnPrecision(range, decimals);
+	return false;
+}
+
 /*!
   Returns width of the \a column in characters of the normal font.
   Columns are 1-indexed.
@@ -651,6 +686,17 @@ bool Document::isColumnHidden(int column)
 	return false;
 }
 
+/*!
+  Returns the number of decimals numeric values of \a column are stored
+  with, or -1 for full precision. Columns are 1-indexed.
+ */
+int Document::columnPrecision(int column)
+{
+	if (Worksheet *sheet = currentWorksheet())
+	   return sheet->columnPrecision(column);
+	return -1;
+}
+
 /*!
   Sets the \a format of the \a row.
   Rows are 1-indexed.
@@ -70,59 +70,36 @@ WorksheetPrivate::~WorksheetPrivate()
 }
 
 /*
-  Calculate the "spans" attribute of the <row> tag. This is an
+  Maintain the "spans" attribute of the <row> tag. This is an
   XLSX optimisation and isn't strictly required. However, it
   makes comparing files easier. The span is the same for each
-  block of 16 rows.
+  block of 16 rows, and is widened here every time a cell is
+  stored so that saving never has to rescan the sheet.
  */
-void WorksheetPrivate::calculateSpans() const
+void WorksheetPrivate::updateSpans(int row, int col)
 {
-	row_spans.clear();
-	int span_min = XLSX_COLUMN_MAX+1;
-	int span_max = -1;
-
-	for (int row_num = dimension.firstRow(); row_num <= dimension.lastRow(); row_num++) {
-		if (cellTable.contains(row_num)) {
-			for (int col_num = dimension.firstColumn(); col_num <= dimension.lastColumn(); col_num++) {
-				if (cellTable[row_num].contains(col_num)) {
-					if (span_max == -1) {
-						span_min = col_num;
-						span_max = col_num;
-					} else {
-						if (col_num < span_min)
-							span_min = col_num;
-						else if (col_num > span_max)
-							span_max = col_num;
-					}
-				}
-			}
-		}
-		if (comments.contains(row_num)) {
-			for (int col_num = dimension.firstColumn(); col_num <= dimension.lastColumn(); col_num++) {
-				if (comments[row_num].contains(col_num)) {
-					if (span_max == -1) {
-						span_min = col_num;
-						span_max = col_num;
-					} else {
-						if (col_num < span_min)
-							span_min = col_num;
-						else if (col_num > span_max)
-							span_max = col_num;
-					}
-				}
-			}
-		}
-
-		if (row_num%16 == 0 || row_num == dimension.lastRow()) {
-			if (span_max != -1) {
-				row_spans[row_num / 16] = QStringLiteral("%1:%2").arg(span_min).arg(span_max);
-				span_min = XLSX_COLUMN_MAX+1;
-				span_max = -1;
-			}
-		}
+	const int span_index = (row-1) / 16;
+	QMap<int, QPair<int, int> >::iterator it = row_spans.find(span_index);
+	if (it == row_spans.end()) {
+		row_spans.insert(span_index, qMakePair(col, col));
+	} else {
+		if (col < it.value().first)
+			it.value().first = col;
+		if (col > it.value().second)
+			it.value().second = col;
 	}
 }
 
+/*
+  Store \a cell at (\a row, \a col) and keep the row spans up to date.
+  All writes into cellTable should go through here.
+ */
+void WorksheetPrivate::insertCell(int row, int col, const QSharedPointer<Cell> &cell)
+{
+	cellTable[row][col] = cell;
+	updateSpans(row, col);
+}
+
 
 QString WorksheetPrivate::generateDimensionString() const
 {
@@ -147,6 +124,10 @@ int WorksheetPrivate::checkDimensions(int row, int col, bool ignore_row, bool ig
 	if (row > XLSX_ROW_MAX || row < 1 || col > XLSX_COLUMN_MAX || col < 1)
 		return -1;
 
+	//The cells of a finalized sheet have been released, it is read only now
+	if (!finalizedXml.isEmpty())
+		return -1;
+
 	if (!ignore_row) {
 		if (row < dimension.firstRow() || dimension.firstRow() == -1) dimension.setFirstRow(row);
 		if (row > dimension.lastRow()) dimension.setLastRow(row);
@@ -204,7 +185,7 @@ Worksheet *Worksheet::copy(const QString &distName, int distId) const
 			if (cell->cellType() == Cell::SharedStringType)
 				d->workbook->sharedStrings()->addSharedString(cell->d_ptr->richString);
 
-			sheet_d->cellTable[row][col] = cell;
+			sheet_d->insertCell(row, col, cell);
 		}
 	}
 
@@ -611,7 +592,7 @@ bool Worksheet::writeString(int row, int column, const RichString &value, const
 	d->workbook->styles()->addXfFormat(fmt);
 	QSharedPointer<Cell> cell = QSharedPointer<Cell>(new Cell(value.toPlainString(), Cell::SharedStringType, fmt, this));
 	cell->d_ptr->richString = value;
-	d->cellTable[row][column] = cell;
+	d->insertCell(row, column, cell);
 	return true;
 }
 
@@ -679,7 +660,7 @@ bool Worksheet::writeInlineString(int row, int column, const QString &value, con
 
 	Format fmt = format.isValid() ? format : d->cellFormat(row, column);
 	d->workbook->styles()->addXfFormat(fmt);
-	d->cellTable[row][column] = QSharedPointer<Cell>(new Cell(value, Cell::InlineStringType, fmt, this));
+	d->insertCell(row, column, QSharedPointer<Cell>(new Cell(value, Cell::InlineStringType, fmt, this)));
 	return true;
 }
 
@@ -708,7 +689,7 @@ bool Worksheet::writeNumeric(int row, int column, double value, const Format &fo
 
 	Format fmt = format.isValid() ? format : d->cellFormat(row, column);
 	d->workbook->styles()->addXfFormat(fmt);
-	d->cellTable[row][column] = QSharedPointer<Cell>(new Cell(value, Cell::NumberType, fmt, this));
+	d->insertCell(row, column, QSharedPointer<Cell>(new Cell(value, Cell::NumberType, fmt, this)));
 	return true;
 }
 
@@ -751,7 +732,7 @@ bool Worksheet::writeFormula(int row, int column, const CellFormula &formula_, c
 
 	QSharedPointer<Cell> data = QSharedPointer<Cell>(new Cell(result, Cell::NumberType, fmt, this));
 	data->d_ptr->formula = formula;
-	d->cellTable[row][column] = data;
+	d->insertCell(row, column, data);
 
 	CellRange range = formula.reference();
 	if (formula.formulaType() == CellFormula::SharedType) {
@@ -765,7 +746,7 @@ bool Worksheet::writeFormula(int row, int column, const CellFormula &formula_, c
 					} else {
 						QSharedPointer<Cell> newCell = QSharedPointer<Cell>(new Cell(result, Cell::NumberType, fmt, this));
 						newCell->d_ptr->formula = sf;
-						d->cellTable[r][c] = newCell;
+						d->insertCell(r, c, newCell);
 					}
 				}
 			}
@@ -804,7 +785,7 @@ bool Worksheet::writeBlank(int row, int column, const Format &format)
 	d->workbook->styles()->addXfFormat(fmt);
 
 	//Note: NumberType with an invalid QVariant value means blank.
-	d->cellTable[row][column] = QSharedPointer<Cell>(new Cell(QVariant(), Cell::NumberType, fmt, this));
+	d->insertCell(row, column, QSharedPointer<Cell>(new Cell(QVariant(), Cell::NumberType, fmt, this)));
 
 	return true;
 }
@@ -833,7 +814,7 @@ bool Worksheet::writeBool(int row, int column, bool value, const Format &format)
 
 	Format fmt = format.isValid() ? format : d->cellFormat(row, column);
 	d->workbook->styles()->addXfFormat(fmt);
-	d->cellTable[row][column] = QSharedPointer<Cell>(new Cell(value, Cell::BooleanType, fmt, this));
+	d->insertCell(row, column, QSharedPointer<Cell>(new Cell(value, Cell::BooleanType, fmt, this)));
 
 	return true;
 }
@@ -867,7 +848,7 @@ bool Worksheet::writeDateTime(int row, int column, const QDateTime &dt, const Fo
 
 	double value = datetimeToNumber(dt, d->workbook->isDate1904());
 
-	d->cellTable[row][column] = QSharedPointer<Cell>(new Cell(value, Cell::NumberType, fmt, this));
+	d->insertCell(row, column, QSharedPointer<Cell>(new Cell(value, Cell::NumberType, fmt, this)));
 
 	return true;
 }
@@ -900,7 +881,7 @@ bool Worksheet::writeTime(int row, int column, const QTime &t, const Format &for
 		fmt.setNumberFormat(QStringLiteral("hh:mm:ss"));
 	d->workbook->styles()->addXfFormat(fmt);
 
-	d->cellTable[row][column] = QSharedPointer<Cell>(new Cell(timeToNumber(t), Cell::NumberType, fmt, this));
+	d->insertCell(row, column, QSharedPointer<Cell>(new Cell(timeToNumber(t), Cell::NumberType, fmt, this)));
 
 	return true;
 }
@@ -965,7 +946,7 @@ bool Worksheet::writeHyperlink(int row, int column, const QUrl &url, const Forma
 
 	//Write the hyperlink string as normal string.
 	d->sharedStrings()->addSharedString(displayString);
-	d->cellTable[row][column] = QSharedPointer<Cell>(new Cell(displayString, Cell::SharedStringType, fmt, this));
+	d->insertCell(row, column, QSharedPointer<Cell>(new Cell(displayString, Cell::SharedStringType, fmt, this)));
 
 	//Store the hyperlink data in a separate table
 	d->urlTable[row][column] = QSharedPointer<XlsxHyperlinkData>(new XlsxHyperlinkData(XlsxHyperlinkData::External, urlString, locationString, QString(), tip));
@@ -1131,6 +1112,12 @@ QList<CellRange> Worksheet::mergedCells() const
 void Worksheet::saveToXmlFile(QIODevice *device) const
 {
 	Q_D(const Worksheet);
+	if (!d->finalizedXml.isEmpty()) {
+		//Relationships were generated when the sheet was finalized, keep them
+		device->write(d->finalizedXml);
+		return;
+	}
+
 	d->relationships->clear();
 
 	QXmlStreamWriter writer(device);
@@ -1221,8 +1208,11 @@ void Worksheet::saveToXmlFile(QIODevice *device) const
 	writer.writeEndElement();//sheetData
 
 	d->saveXmlMergeCells(writer);
-	foreach (const ConditionalFormatting cf, d->conditionalFormattingList)
-		cf.saveToXml(writer);
+	for (int i=0; i<d->conditionalFormattingList.size(); ++i) {
+		//Formattings baked into the cell styles are not written
+		if (!d->bakedCfIndexes.contains(i))
+			d->conditionalFormattingList[i].saveToXml(writer);
+	}
 	d->saveXmlDataValidations(writer);
 
     //{{ liufeijin :  write  pagesettings  add by liufeijin 20181028
@@ -1298,6 +1288,40 @@ void Worksheet::saveToXmlFile(QIODevice *device) const
 	writer.writeEndDocument();
 }
 
+/*!
+  Serializes the sheet once and releases its cells. The saved XML is
+  reused every time the workbook is saved afterwards, so a workbook with
+  many finished sheets only keeps their text in memory instead of their
+  cell tables. Writes to a finalized sheet fail, and reads return nothing.
+
+  \note Sheets holding drawings should not be deleted from the workbook
+  after a sheet with drawings has been finalized, as the drawing indexes
+  are fixed at this point.
+ */
+void Worksheet::finalize()
+{
+	Q_D(Worksheet);
+	if (!d->finalizedXml.isEmpty())
+		return;
+
+	QByteArray xml = saveToXmlData();
+	d->cellTable.clear();
+	d->comments.clear();
+	d->urlTable.clear();
+	d->row_spans.clear();
+	d->sharedFormulaMap.clear();
+	d->finalizedXml = xml;
+}
+
+/*!
+  Returns true if the sheet has been finalized and its cells released.
+ */
+bool Worksheet::isFinalized() const
+{
+	Q_D(const Worksheet);
+	return !d->finalizedXml.isEmpty();
+}
+
 //{{ liufeijin 
 bool Worksheet::setStartPage(int spagen)
 {
@@ -1311,26 +1335,40 @@ bool Worksheet::setStartPage(int spagen)
 
 void WorksheetPrivate::saveXmlSheetData(QXmlStreamWriter &writer) const
 {
-	calculateSpans();
-	for (int row_num = dimension.firstRow(); row_num <= dimension.lastRow(); row_num++) {
-		if (!(cellTable.contains(row_num) || comments.contains(row_num) || rowsInfo.contains(row_num))) {
-			//Only process rows with cell data / comments / formatting
-			continue;
-		}
+	bakedCfIndexes.clear();
+	bakedXfIndexes.clear();
+	for (int i=0; i<conditionalFormattingList.size(); ++i) {
+		const ConditionalFormatting &cf = conditionalFormattingList[i];
+		if (cf.isStatic() && !rangesHaveFormula(cf.ranges()))
+			bakedCfIndexes.append(i);
+	}
 
-		int span_index = (row_num-1) / 16;
-		QString span;
-		if (row_spans.contains(span_index))
-			span = row_spans[span_index];
+	//Only rows with cell data / comments / formatting are written, so walk
+	//the three sorted row maps in step instead of every row in the dimension.
+	QMap<int, QMap<int, QSharedPointer<Cell> > >::const_iterator cellIt = cellTable.lowerBound(dimension.firstRow());
+	QMap<int, QMap<int, QString> >::const_iterator commentIt = comments.lowerBound(dimension.firstRow());
+	QMap<int, QSharedPointer<XlsxRowInfo> >::const_iterator infoIt = rowsInfo.lowerBound(dimension.firstRow());
+
+	forever {
+		int row_num = XLSX_ROW_MAX + 1;
+		if (cellIt != cellTable.constEnd())
+			row_num = qMin(row_num, cellIt.key());
+		if (commentIt != comments.constEnd())
+			row_num = qMin(row_num, commentIt.key());
+		if (infoIt != rowsInfo.constEnd())
+			row_num = qMin(row_num, infoIt.key());
+		if (row_num > dimension.lastRow())
+			break;
 
 		writer.writeStartElement(QStringLiteral("row"));
 		writer.writeAttribute(QStringLiteral("r"), QString::number(row_num));
 
-		if (!span.isEmpty())
-			writer.writeAttribute(QStringLiteral("spans"), span);
+		QMap<int, QPair<int, int> >::const_iterator spanIt = row_spans.constFind((row_num-1) / 16);
+		if (spanIt != row_spans.constEnd())
+			writer.writeAttribute(QStringLiteral("spans"), QStringLiteral("%1:%2").arg(spanIt.value().first).arg(spanIt.value().second));
 
-		if (rowsInfo.contains(row_num)) {
-			QSharedPointer<XlsxRowInfo> rowInfo = rowsInfo[row_num];
+		if (infoIt != rowsInfo.constEnd() && infoIt.key() == row_num) {
+			QSharedPointer<XlsxRowInfo> rowInfo = infoIt.value();
 			if (!rowInfo->format.isEmpty()) {
 				writer.writeAttribute(QStringLiteral("s"), QString::number(rowInfo->format.xfIndex()));
 				writer.writeAttribute(QStringLiteral("customFormat"), QStringLiteral("1"));
@@ -1350,20 +1388,100 @@ void WorksheetPrivate::saveXmlSheetData(QXmlStreamWriter &writer) const
 				writer.writeAttribute(QStringLiteral("outlineLevel"), QString::number(rowInfo->outlineLevel));
 			if (rowInfo->collapsed)
 				writer.writeAttribute(QStringLiteral("collapsed"), QStringLiteral("1"));
+			++infoIt;
 		}
 
-		//Write cell data if row contains filled cells
-		if (cellTable.contains(row_num)) {
-			for (int col_num = dimension.firstColumn(); col_num <= dimension.lastColumn(); col_num++) {
-				if (cellTable[row_num].contains(col_num)) {
-					saveXmlCellData(writer, row_num, col_num, cellTable[row_num][col_num]);
-				}
-			}
+		//Write cell data if row contains filled cells. The row map is
+		//ordered by column, so this only visits occupied columns.
+		if (cellIt != cellTable.constEnd() && cellIt.key() == row_num) {
+			QMap<int, QSharedPointer<Cell> >::const_iterator colIt = cellIt.value().constBegin();
+			for (; colIt != cellIt.value().constEnd(); ++colIt)
+				saveXmlCellData(writer, row_num, colIt.key(), colIt.value());
+			++cellIt;
 		}
+		if (commentIt != comments.constEnd() && commentIt.key() == row_num)
+			++commentIt;
+
 		writer.writeEndElement(); //row
 	}
 }
 
+/*
+  Returns true if any cell inside \a ranges holds a formula. Such cells only
+  carry the value cached when the formula was last calculated, so rules
+  on them are left for Excel to evaluate.
+ */
+bool WorksheetPrivate::rangesHaveFormula(const QList<CellRange> &ranges) const
+{
+	foreach (const CellRange &range, ranges) {
+		QMap<int, QMap<int, QSharedPointer<Cell> > >::const_iterator rowIt = cellTable.lowerBound(range.firstRow());
+		for (; rowIt != cellTable.constEnd() && rowIt.key() <= range.lastRow(); ++rowIt) {
+			QMap<int, QSharedPointer<Cell> >::const_iterator colIt = rowIt.value().lowerBound(range.firstColumn());
+			for (; colIt != rowIt.value().constEnd() && colIt.key() <= range.lastColumn(); ++colIt) {
+				if (colIt.value()->hasFormula())
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+/*
+  Returns the style index for the cell (\a row, \a col) holding \a value
+  with \a format, with the formats of the matching rules of the first
+  conditional formatting baked on save merged in. Baked styles are
+  interned, so cells sharing a style and the same matching rules share
+  one xf entry.
+ */
+int WorksheetPrivate::bakedXfIndex(int row, int col, double value, const Format &format) const
+{
+	const int baseIndex = format.isEmpty() ? -1 : format.xfIndex();
+	for (int i=0; i<bakedCfIndexes.size(); ++i) {
+		const ConditionalFormatting &cf = conditionalFormattingList[bakedCfIndexes[i]];
+		const quint64 rules = cf.matchStaticRules(row, col, value);
+		if (rules == 0)
+			continue;
+
+		const QPair<int, QPair<int, quint64> > key(baseIndex, qMakePair(bakedCfIndexes[i], rules));
+		QHash<QPair<int, QPair<int, quint64> >, int>::const_iterator it = bakedXfIndexes.constFind(key);
+		if (it != bakedXfIndexes.constEnd())
+			return it.value();
+
+		//Merge from the lowest priority up, so the highest priority rule
+		//wins where formats conflict
+		Format baked = format;
+		const QList<int> order = cf.d->priorityOrder();
+		for (int j=order.size()-1; j>=0; --j) {
+			if (rules & (quint64(1) << order[j]))
+				baked.mergeFormat(cf.d->cfRules[order[j]]->dxfFormat);
+		}
+		workbook->styles()->addXfFormat(baked);
+		bakedXfIndexes.insert(key, baked.xfIndex());
+		return baked.xfIndex();
+	}
+	return baseIndex;
+}
+
+/*
+  Format \a value with at most \a decimals fractional digits, dropping
+  trailing zeros so that e.g. 21.50 is stored as "21.5".
+ */
+static QString numberToPrecisionString(double value, int decimals)
+{
+	QString text = QString::number(value, 'f', decimals);
+	if (decimals > 0 && text.contains(QLatin1Char('.'))) {
+		int end = text.size();
+		while (text.at(end-1) == QLatin1Char('0'))
+			--end;
+		if (text.at(end-1) == QLatin1Char('.'))
+			--end;
+		text.truncate(end);
+	}
+	if (text == QLatin1String("-0"))
+		return QStringLiteral("0");
+	return text;
+}
+
 void WorksheetPrivate::saveXmlCellData(QXmlStreamWriter &writer, int row, int col, QSharedPointer<Cell> cell) const
 {
 	//This is the innermost loop so efficiency is important.
@@ -1373,12 +1491,17 @@ void WorksheetPrivate::saveXmlCellData(QXmlStreamWriter &writer, int row, int co
 	writer.writeAttribute(QStringLiteral("r"), cell_pos);
 
 	//Style used by the cell, row or col
-	if (!cell->format().isEmpty())
-		writer.writeAttribute(QStringLiteral("s"), QString::number(cell->format().xfIndex()));
-	else if (rowsInfo.contains(row) && !rowsInfo[row]->format.isEmpty())
-		writer.writeAttribute(QStringLiteral("s"), QString::number(rowsInfo[row]->format.xfIndex()));
-	else if (colsInfoHelper.contains(col) && !colsInfoHelper[col]->format.isEmpty())
-		writer.writeAttribute(QStringLiteral("s"), QString::number(colsInfoHelper[col]->format.xfIndex()));
+	Format format = cell->format();
+	if (format.isEmpty() && rowsInfo.contains(row) && !rowsInfo[row]->format.isEmpty())
+		format = rowsInfo[row]->format;
+	else if (format.isEmpty() && colsInfoHelper.contains(col) && !colsInfoHelper[col]->format.isEmpty())
+		format = colsInfoHelper[col]->format;
+
+	int xfIndex = format.isEmpty() ? -1 : format.xfIndex();
+	if (!bakedCfIndexes.isEmpty() && cell->cellType() == Cell::NumberType && cell->value().isValid())
+		xfIndex = bakedXfIndex(row, col, cell->value().toDouble(), format);
+	if (xfIndex != -1)
+		writer.writeAttribute(QStringLiteral("s"), QString::number(xfIndex));
 
 	if (cell->cellType() == Cell::SharedStringType) {
 		int sst_idx;
@@ -1423,7 +1546,11 @@ void WorksheetPrivate::saveXmlCellData(QXmlStreamWriter &writer, int row, int co
 			cell->formula().saveToXml(writer);
 		if (cell->value().isValid()) {//note that, invalid value means 'v' is blank
 			double value = cell->value().toDouble();
-			writer.writeTextElement(QStringLiteral("v"), QString::number(value, 'g', 15));
+			QMap<int, int>::const_iterator precisionIt = colsPrecision.constFind(col);
+			if (precisionIt != colsPrecision.constEnd())
+				writer.writeTextElement(QStringLiteral("v"), numberToPrecisionString(value, precisionIt.value()));
+			else
+				writer.writeTextElement(QStringLiteral("v"), QString::number(value, 'g', 15));
 		}
 	} else if (cell->cellType() == Cell::StringType) {
 		writer.writeAttribute(QStringLiteral("t"), QStringLiteral("str"));
@@ -1667,6 +1794,64 @@ bool Worksheet::setColumnFormat(int colFirst, int colLast, const Format &format)
 	return false;
 }
 
+/*!
+  Stores numeric values in columns [\a colFirst, \a colLast] with at most
+  \a decimals digits after the decimal point, and gives the columns a
+  matching shared number format. The values kept in memory are not changed;
+  only the text written to the sheet is rounded, with trailing zeros removed.
+  Columns are 1-indexed. Returns true on success.
+ */
+bool Worksheet::setColumnPrecision(int colFirst, int colLast, int decimals)
+{
+	Q_D(Worksheet);
+
+	if (decimals < 0 || decimals > 15)
+		return false;
+
+	QList <QSharedPointer<XlsxColumnInfo> > columnInfoList = d->getColumnInfoList(colFirst, colLast);
+	if (columnInfoList.isEmpty())
+		return false;
+
+	QString numFmt = QStringLiteral("0");
+	if (decimals > 0)
+		numFmt += QLatin1Char('.') + QString(decimals, QLatin1Char('0'));
+
+	foreach(QSharedPointer<XlsxColumnInfo>  columnInfo, columnInfoList) {
+		Format format = columnInfo->format;
+		format.setNumberFormat(numFmt);
+		d->workbook->styles()->addXfFormat(format);
+		columnInfo->format = format;
+	}
+
+	for (int col = colFirst; col <= colLast; ++col)
+		d->colsPrecision[col] = decimals;
+
+	return true;
+}
+
+/*!
+  \overload
+  Sets the stored precision of the columns in \a range to \a decimals.
+  Returns true on success.
+ */
+bool Worksheet::setColumnPrecision(const CellRange &range, int decimals)
+{
+	if (!range.isValid())
+		return false;
+
+	return setColumnPrecision(range.firstColumn(), range.lastColumn(), decimals);
+}
+
+/*!
+  Returns the number of decimals numeric values of \a column are stored
+  with, or -1 if the column uses full precision. Columns are 1-indexed.
+ */
+int Worksheet::columnPrecision(int column) const
+{
+	Q_D(const Worksheet);
+	return d->colsPrecision.value(column, -1);
+}
+
 /*!
   Sets hidden property of a range of columns [\a colFirst, \a colLast] to \a hidden.
   Columns are 1-indexed. Returns true on success.
@@ -2128,7 +2313,7 @@ void WorksheetPrivate::loadXmlSheetData(QXmlStreamReader &reader)
 					}
 				}
 
-				cellTable[pos.row()][pos.column()] = cell;
+				insertCell(pos.row(), pos.column(), cell);
 			}
 		}
 	}